@@ -0,0 +1,242 @@
+/**
+ * @file archive_benchmark.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ *
+ * Benchmarks for the native archive extraction engine. These exercise the
+ * pure C++ paths shared with the stacs.native.archive extension - format
+ * support selection, header iteration, member reads, and full extraction -
+ * without pulling in pybind11 or a Python interpreter.
+ *
+ * Fixture archives are generated by generate_fixtures.py and are expected
+ * under fixtures/ relative to the working directory. See the README in this
+ * directory for usage.
+ */
+
+#include <benchmark/benchmark.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "../stacs/native/archive/src/extractor.hpp"
+
+extern "C" {
+#include <archive.h>
+#include <archive_entry.h>
+}
+
+/**
+ * Opens the provided fixture with support enabled for the provided MIME type
+ * hint, returning the handle. Aborts the benchmark on failure, as a missing
+ * fixture invalidates every measurement after it.
+ *
+ * @return struct archive*
+ */
+static struct archive *openFixture(benchmark::State &state,
+                                   const std::string &fixture,
+                                   const std::string &mime) {
+    struct archive *reader = archive_read_new();
+
+    enableSupport(reader, mime);
+
+    if (archive_read_open_filename(reader, fixture.c_str(), 10240)
+        != ARCHIVE_OK) {
+        state.SkipWithError("Unable to open fixture - run 'make fixtures'");
+        archive_read_free(reader);
+        return NULL;
+    }
+
+    return reader;
+}
+
+/**
+ * Measures the cost of opening an archive - allocation, format support
+ * selection from the MIME hint, and the bidding performed against the leading
+ * bytes - through to the first header.
+ */
+static void BM_Open(benchmark::State &state,
+                    const std::string &fixture,
+                    const std::string &mime) {
+    for (auto _ : state) {
+        struct archive *reader = openFixture(state, fixture, mime);
+
+        if (reader == NULL) {
+            return;
+        }
+
+        struct archive_entry *entry;
+        archive_read_next_header(reader, &entry);
+        archive_read_free(reader);
+    }
+}
+
+/**
+ * Measures the rate at which member headers can be walked, with data skipped
+ * per member - the manifest-only listing path.
+ */
+static void BM_Headers(benchmark::State &state,
+                       const std::string &fixture,
+                       const std::string &mime) {
+    int64_t members = 0;
+
+    for (auto _ : state) {
+        struct archive *reader = openFixture(state, fixture, mime);
+
+        if (reader == NULL) {
+            return;
+        }
+
+        struct archive_entry *entry;
+
+        while (archive_read_next_header(reader, &entry) == ARCHIVE_OK) {
+            archive_read_data_skip(reader);
+            members++;
+        }
+
+        archive_read_free(reader);
+    }
+
+    state.SetItemsProcessed(members);
+}
+
+/**
+ * Measures decompressed read throughput, with the read chunk size swept via
+ * the benchmark argument - the path exercised by ArchiveReader.read().
+ */
+static void BM_Read(benchmark::State &state,
+                    const std::string &fixture,
+                    const std::string &mime) {
+    std::vector<char> chunk(state.range(0));
+    int64_t bytes = 0;
+
+    for (auto _ : state) {
+        struct archive *reader = openFixture(state, fixture, mime);
+
+        if (reader == NULL) {
+            return;
+        }
+
+        struct archive_entry *entry;
+
+        while (archive_read_next_header(reader, &entry) == ARCHIVE_OK) {
+            while (true) {
+                int result = archive_read_data(reader,
+                                               chunk.data(),
+                                               chunk.size());
+
+                if (result <= 0) {
+                    break;
+                }
+
+                bytes += result;
+            }
+        }
+
+        archive_read_free(reader);
+    }
+
+    state.SetBytesProcessed(bytes);
+}
+
+/**
+ * Measures end-to-end extraction to disk - the extract_all path - including
+ * the writer thread and per-member filtering, into a fresh directory per
+ * iteration. Directory creation and removal are excluded from timing.
+ */
+static void BM_Extract(benchmark::State &state,
+                       const std::string &fixture,
+                       const std::string &mime) {
+    int64_t bytes = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+
+        char directory[] = "/tmp/stacs-benchmark-XXXXXX";
+
+        if (mkdtemp(directory) == NULL) {
+            state.SkipWithError("Unable to create extraction directory");
+            return;
+        }
+
+        state.ResumeTiming();
+
+        ExtractionStats stats;
+
+        try {
+            extractArchiveToDisk(fixture,
+                                 directory,
+                                 std::vector<NestedMagic>(),
+                                 ExtractionFilters(),
+                                 ExtractionLimits(),
+                                 0,
+                                 &stats);
+        } catch (const ArchiveError &) {
+            state.SkipWithError("Extraction failed - run 'make fixtures'");
+            return;
+        }
+
+        bytes += stats.produced;
+
+        state.PauseTiming();
+
+        std::string removal = std::string("rm -rf ") + directory;
+
+        if (system(removal.c_str()) != 0) {
+            state.SkipWithError("Unable to remove extraction directory");
+            return;
+        }
+
+        state.ResumeTiming();
+    }
+
+    state.SetBytesProcessed(bytes);
+}
+
+// Open cost per format, against the small fixtures - the cost being measured
+// is per archive, not per byte.
+BENCHMARK_CAPTURE(BM_Open, tar, "fixtures/small.tar", "application/x-tar");
+BENCHMARK_CAPTURE(BM_Open, tar_gz, "fixtures/small.tar.gz", "application/gzip");
+BENCHMARK_CAPTURE(BM_Open, zip, "fixtures/small.zip", "application/zip");
+BENCHMARK_CAPTURE(BM_Open,
+                  tar_unhinted,
+                  "fixtures/small.tar",
+                  "");
+
+// Header iteration rate over the many-member medium fixtures.
+BENCHMARK_CAPTURE(BM_Headers, tar, "fixtures/medium.tar", "application/x-tar");
+BENCHMARK_CAPTURE(BM_Headers,
+                  tar_gz,
+                  "fixtures/medium.tar.gz",
+                  "application/gzip");
+BENCHMARK_CAPTURE(BM_Headers, zip, "fixtures/medium.zip", "application/zip");
+
+// Read throughput with the chunk size swept from 4KiB to 1MiB.
+BENCHMARK_CAPTURE(BM_Read, tar, "fixtures/medium.tar", "application/x-tar")
+    ->RangeMultiplier(4)
+    ->Range(4096, 1048576);
+BENCHMARK_CAPTURE(BM_Read,
+                  tar_gz,
+                  "fixtures/medium.tar.gz",
+                  "application/gzip")
+    ->RangeMultiplier(4)
+    ->Range(4096, 1048576);
+
+// End-to-end extraction at each fixture size.
+BENCHMARK_CAPTURE(BM_Extract,
+                  small_tar_gz,
+                  "fixtures/small.tar.gz",
+                  "application/gzip");
+BENCHMARK_CAPTURE(BM_Extract,
+                  medium_tar_gz,
+                  "fixtures/medium.tar.gz",
+                  "application/gzip");
+BENCHMARK_CAPTURE(BM_Extract,
+                  large_tar_gz,
+                  "fixtures/large.tar.gz",
+                  "application/gzip")
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
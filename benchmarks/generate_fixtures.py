@@ -0,0 +1,74 @@
+"""Generates the fixture archives used by the native benchmarks.
+
+Fixtures are deterministic - member contents are drawn from a seeded PRNG - so
+numbers are comparable between runs and hosts. Each size is produced as a plain
+tar, a gzipped tar, and a zip, under fixtures/ in this directory.
+
+SPDX-License-Identifier: BSD-3-Clause
+"""
+
+import gzip
+import io
+import os
+import random
+import shutil
+import tarfile
+import zipfile
+
+# Member count and per-member size for each fixture, chosen so that 'small'
+# measures per-archive overhead, 'medium' per-member overhead, and 'large'
+# sustained throughput.
+SIZES = {
+    "small": (64, 16 * 1024),
+    "medium": (2048, 32 * 1024),
+    "large": (256, 1024 * 1024),
+}
+
+FIXTURES = os.path.join(os.path.dirname(os.path.abspath(__file__)), "fixtures")
+
+
+def member_data(generator: random.Random, size: int) -> bytes:
+    """Generates member contents of the provided size.
+
+    Half of each member is repeated text and half is pseudo-random, so that
+    compressed fixtures sit at a middling ratio rather than an extreme.
+    """
+    text = b"The quick brown fox jumps over the lazy dog.\n"
+    half = size // 2
+    rest = size - half
+
+    data = text * (half // len(text) + 1)
+    data = data[:half] + generator.getrandbits(rest * 8).to_bytes(rest, "little")
+
+    return data
+
+
+def generate(name: str, members: int, size: int) -> None:
+    """Generates all archive formats for a single fixture size."""
+    generator = random.Random(name)
+    contents = [member_data(generator, size) for _ in range(members)]
+
+    # Plain tar.
+    with tarfile.open(os.path.join(FIXTURES, f"{name}.tar"), "w") as archive:
+        for index, data in enumerate(contents):
+            info = tarfile.TarInfo(f"member-{index:06}")
+            info.size = len(data)
+            archive.addfile(info, io.BytesIO(data))
+
+    # Gzipped tar, from the plain tar just written.
+    with open(os.path.join(FIXTURES, f"{name}.tar"), "rb") as fin:
+        with gzip.open(os.path.join(FIXTURES, f"{name}.tar.gz"), "wb") as fout:
+            shutil.copyfileobj(fin, fout)
+
+    # Zip.
+    with zipfile.ZipFile(os.path.join(FIXTURES, f"{name}.zip"), "w") as archive:
+        for index, data in enumerate(contents):
+            archive.writestr(f"member-{index:06}", data)
+
+
+if __name__ == "__main__":
+    os.makedirs(FIXTURES, exist_ok=True)
+
+    for name, (members, size) in SIZES.items():
+        print(f"Generating {name} fixtures ({members} members of {size} bytes)")
+        generate(name, members, size)
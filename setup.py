@@ -31,6 +31,22 @@ ext_modules = [
         ["stacs/native/archive/src/archive.cpp"],
         libraries=["archive"],
     ),
+    Pybind11Extension(
+        "stacs.native.meta",
+        ["stacs/native/meta/src/meta.cpp"],
+    ),
+    Pybind11Extension(
+        "stacs.native.scanner",
+        ["stacs/native/scanner/src/scanner.cpp"],
+    ),
+    Pybind11Extension(
+        "stacs.native.output",
+        ["stacs/native/output/src/output.cpp"],
+    ),
+    Pybind11Extension(
+        "stacs.native.filter",
+        ["stacs/native/filter/src/filter.cpp"],
+    ),
 ]
 
 setup(
@@ -5,9 +5,13 @@
  */
 
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 
 #include "archiveentry.cpp"
+#include "archiveextractorpool.cpp"
 #include "archivereader.cpp"
+#include "diskwriter.cpp"
+#include "extractor.cpp"
 
 namespace py = pybind11;
 
@@ -16,21 +20,60 @@ PYBIND11_MODULE(archive, module) {
     module.attr("__name__") = "stacs.native.archive";
 
     py::class_<ArchiveReader>(module, "ArchiveReader")
-        .def(py::init<const std::string &>())
+        // The buffer constructor must be registered before the filename
+        // constructor, as bytes-like objects would otherwise be converted to
+        // a filename.
+        .def(py::init<const py::buffer &>())
+        .def(py::init<const std::string &, const std::string &>(),
+             py::arg("filename"),
+             py::arg("format") = "")
+        .def(py::init<int>())
         .def_property_readonly("filename", &ArchiveReader::getFilename)
-        .def_property_readonly("chunk", &ArchiveReader::getChunk)
+        .def_property_readonly("chunk", &ArchiveReader::getChunk, py::keep_alive<0, 1>())
+        .def_property_readonly("stats", &ArchiveReader::getStats)
+        .def_property_readonly("unpacked", &ArchiveReader::getUnpacked)
         .def("__enter__", &ArchiveReader::enter)
         .def("__exit__", &ArchiveReader::exit)
         .def("__iter__", &ArchiveReader::iter)
         .def("__next__", &ArchiveReader::next)
+        .def("entries", &ArchiveReader::entries)
         .def("read", &ArchiveReader::read)
+        .def("read_into", &ArchiveReader::readInto)
+        .def("read_member", &ArchiveReader::readMember, py::keep_alive<0, 1>())
+        .def("extract_all",
+             &ArchiveReader::extractAll,
+             py::arg("directory"),
+             py::arg("nested") = std::vector<NestedMagic>(),
+             py::arg("max_member_size") = 0,
+             py::arg("max_total_size") = 0,
+             py::arg("max_ratio") = 0,
+             py::arg("skip_larger_than") = 0,
+             py::arg("skip_patterns") = std::vector<std::string>(),
+             py::arg("regular_only") = false)
         .doc() = "An interface to read archive contents (via libarchive)";
 
+    py::class_<ExtractionResult>(module, "ExtractionResult")
+        .def_readonly("filename", &ExtractionResult::filename)
+        .def_readonly("directory", &ExtractionResult::directory)
+        .def_readonly("success", &ExtractionResult::success)
+        .def_readonly("error", &ExtractionResult::error)
+        .doc() = "Represents the result of a pooled extraction";
+
+    py::class_<ArchiveExtractorPool>(module, "ArchiveExtractorPool")
+        .def(py::init<int>(), py::arg("workers") = 4)
+        .def("submit", &ArchiveExtractorPool::submit)
+        .def("close", &ArchiveExtractorPool::close)
+        .def("__iter__", &ArchiveExtractorPool::iter)
+        .def("__next__", &ArchiveExtractorPool::next)
+        .doc() = "Extracts multiple archives concurrently on native workers";
+
     py::class_<ArchiveEntry>(module, "ArchiveEntry")
         .def_property_readonly("filename", &ArchiveEntry::getFilename)
         .def_property_readonly("isdir", &ArchiveEntry::isDirectory)
         .def_property_readonly("size", &ArchiveEntry::getSize)
+        .def_property_readonly("mode", &ArchiveEntry::getMode)
         .doc() = "Represents a member of an Archive";
 
     py::register_exception<ArchiveError>(module, "ArchiveError");
+    py::register_exception<ArchiveBombError>(module, "ArchiveBombError");
 }
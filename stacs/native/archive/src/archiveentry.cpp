@@ -1,5 +1,5 @@
 /**
- * @file archivereader.cpp
+ * @file archiveentry.cpp
  * @author Peter Adkins
  * @date 2022-07-02
  */
@@ -11,7 +11,15 @@
 #include <string>
 
 ArchiveEntry::ArchiveEntry(struct archive_entry *entry) {
-    this->entry = entry;
+    // Snapshot all fields at construction: libarchive invalidates the
+    // underlying entry as soon as the reader advances to the next header, so
+    // retaining the raw pointer would dangle once iteration moves on.
+    const char *pathname = archive_entry_pathname_utf8(entry);
+
+    this->filename = pathname != NULL ? pathname : "";
+    this->size = archive_entry_size(entry);
+    this->mode = archive_entry_mode(entry);
+    this->directory = S_ISDIR(this->mode) != 0;
 }
 
 ArchiveEntry::~ArchiveEntry() {
@@ -23,7 +31,7 @@ ArchiveEntry::~ArchiveEntry() {
  * @return std::string
  */
 std::string ArchiveEntry::getFilename() {
-    return archive_entry_pathname_utf8(this->entry);
+    return this->filename;
 }
 
 /**
@@ -32,7 +40,16 @@ std::string ArchiveEntry::getFilename() {
  * @return int64_t
  */
 int64_t ArchiveEntry::getSize() {
-    return archive_entry_size(this->entry);
+    return this->size;
+}
+
+/**
+ * Gets the mode of the archive member.
+ *
+ * @return int
+ */
+int ArchiveEntry::getMode() {
+    return this->mode;
 }
 
 /**
@@ -41,9 +58,5 @@ int64_t ArchiveEntry::getSize() {
  * @return bool
  */
 bool ArchiveEntry::isDirectory() {
-    if (S_ISDIR(archive_entry_mode(this->entry)) != 0) {
-        return true;
-    } else {
-        return false;
-    }
+    return this->directory;
 }
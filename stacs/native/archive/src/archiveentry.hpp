@@ -1,5 +1,5 @@
 /**
- * @file archivereader.cpp
+ * @file archiveentry.hpp
  * @author Peter Adkins
  * @date 2022-07-02
  */
@@ -20,8 +20,12 @@ class ArchiveEntry {
 
     std::string getFilename();
     int64_t getSize();
+    int getMode();
     bool isDirectory();
 
    private:
-    struct archive_entry *entry;
+    std::string filename;
+    int64_t size;
+    int mode;
+    bool directory;
 };
@@ -0,0 +1,143 @@
+/**
+ * @file archiveextractorpool.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "archiveextractorpool.hpp"
+
+#include "extractor.hpp"
+
+ArchiveExtractorPool::ArchiveExtractorPool(int workers) {
+    this->closed = false;
+    this->submitted = 0;
+    this->delivered = 0;
+
+    for (int index = 0; index < workers; index++) {
+        this->threads.emplace_back(&ArchiveExtractorPool::worker, this);
+    }
+}
+
+ArchiveExtractorPool::~ArchiveExtractorPool() {
+    this->close();
+
+    for (std::thread &thread : this->threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+/**
+ * Consumes tasks from the shared queue until the pool is closed and the queue
+ * has been drained. Workers never touch Python state, so extraction runs
+ * entirely outside of the GIL.
+ */
+void ArchiveExtractorPool::worker() {
+    while (true) {
+        std::pair<std::string, std::string> task;
+
+        {
+            std::unique_lock<std::mutex> guard(this->lock);
+
+            this->available.wait(guard, [this] {
+                return this->closed || !this->tasks.empty();
+            });
+
+            if (this->tasks.empty()) {
+                return;
+            }
+
+            task = this->tasks.front();
+            this->tasks.pop_front();
+        }
+
+        ExtractionResult result;
+        result.filename = task.first;
+        result.directory = task.second;
+        result.success = true;
+
+        try {
+            extractArchiveToDisk(task.first,
+                                 task.second,
+                                 std::vector<NestedMagic>(),
+                                 ExtractionFilters(),
+                                 ExtractionLimits(),
+                                 0);
+        } catch (const std::exception &err) {
+            result.success = false;
+            result.error = err.what();
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->results.push_back(result);
+        }
+
+        this->available.notify_all();
+    }
+}
+
+/**
+ * Queues an archive for extraction to the provided directory.
+ */
+void ArchiveExtractorPool::submit(const std::string &filename,
+                                  const std::string &directory) {
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        if (this->closed) {
+            throw std::runtime_error("Cannot submit to a closed pool");
+        }
+
+        this->tasks.push_back(std::make_pair(filename, directory));
+        this->submitted++;
+    }
+
+    this->available.notify_all();
+}
+
+/**
+ * Marks the pool as closed. Queued work is still completed, but no further
+ * archives may be submitted, and iteration will end once all results have
+ * been delivered.
+ */
+void ArchiveExtractorPool::close() {
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->closed = true;
+    }
+
+    this->available.notify_all();
+}
+
+ArchiveExtractorPool *ArchiveExtractorPool::iter() {
+    return this;
+}
+
+/**
+ * Returns the next completed extraction, blocking - with the GIL released -
+ * until one is available. Iteration ends once the pool has been closed and
+ * every submitted archive has been reported.
+ *
+ * @return ExtractionResult
+ */
+ExtractionResult ArchiveExtractorPool::next() {
+    pybind11::gil_scoped_release release;
+    std::unique_lock<std::mutex> guard(this->lock);
+
+    this->available.wait(guard, [this] {
+        return !this->results.empty() ||
+               (this->closed && this->delivered == this->submitted);
+    });
+
+    if (this->results.empty()) {
+        throw pybind11::stop_iteration();
+    }
+
+    ExtractionResult result = this->results.front();
+    this->results.pop_front();
+    this->delivered++;
+
+    return result;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file archiveextractorpool.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+#include <pybind11/pybind11.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class ExtractionResult {
+   public:
+    std::string filename;
+    std::string directory;
+    bool success;
+    std::string error;
+};
+
+class ArchiveExtractorPool {
+   public:
+    ArchiveExtractorPool(int workers);
+    ~ArchiveExtractorPool();
+
+    void submit(const std::string &filename, const std::string &directory);
+    void close();
+    ArchiveExtractorPool *iter();
+    ExtractionResult next();
+
+   private:
+    void worker();
+
+    std::vector<std::thread> threads;
+    std::deque<std::pair<std::string, std::string>> tasks;
+    std::deque<ExtractionResult> results;
+    std::mutex lock;
+    std::condition_variable available;
+    bool closed;
+    size_t submitted;
+    size_t delivered;
+};
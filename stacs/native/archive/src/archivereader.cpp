@@ -6,19 +6,59 @@
 
 #include "archivereader.hpp"
 
+#include <chrono>
+
 #include "archiveentry.hpp"
+#include "extractor.hpp"
 
 extern "C" {
 #include <archive.h>
 #include <archive_entry.h>
 }
 
-const char *ArchiveError::what() const noexcept {
-    return "Unable to open archive for reading\n";
+/**
+ * Returns the current monotonic clock reading, in nanoseconds.
+ *
+ * @return int64_t
+ */
+static int64_t monotonicNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+ArchiveReader::ArchiveReader(const std::string &filename,
+                             const std::string &format)
+    : filename(filename), format(format), source(SOURCE_FILENAME) {
+    this->chunk.resize(CHUNK_SIZE);
+    this->filled = 0;
+    this->resetStats();
 }
 
-ArchiveReader::ArchiveReader(const std::string &filename) : filename(filename) {
+ArchiveReader::ArchiveReader(const pybind11::buffer &buffer)
+    : filename("<memory>"), source(SOURCE_MEMORY), buffer(buffer.request()) {
     this->chunk.resize(CHUNK_SIZE);
+    this->filled = 0;
+    this->resetStats();
+}
+
+ArchiveReader::ArchiveReader(int descriptor)
+    : filename("<fd>"), source(SOURCE_DESCRIPTOR), descriptor(descriptor) {
+    this->chunk.resize(CHUNK_SIZE);
+    this->filled = 0;
+    this->resetStats();
+}
+
+/**
+ * Resets all telemetry counters to zero.
+ */
+void ArchiveReader::resetStats() {
+    this->bytesRead = 0;
+    this->bytesConsumed = 0;
+    this->membersVisited = 0;
+    this->openNanos = 0;
+    this->readNanos = 0;
+    this->unpackedDirs.clear();
 }
 
 ArchiveReader::~ArchiveReader() {
@@ -44,24 +84,180 @@ std::string ArchiveReader::getFilename() {
  * @return int
  */
 int ArchiveReader::read() {
-    int result = archive_read_data(this->archive,
+    int result;
+
+    {
+        // Release the GIL while libarchive decompresses, so that independent
+        // readers can make progress concurrently.
+        pybind11::gil_scoped_release release;
+        int64_t started = monotonicNanos();
+
+        result = archive_read_data(this->archive,
                                    this->chunk.data(),
                                    this->chunk.size());
 
+        this->readNanos += monotonicNanos() - started;
+    }
+
     if (result < 0) {
         throw ArchiveError();
     }
 
+    this->filled = result;
+    this->bytesRead += result;
+
     return result;
 }
 
 /**
- * Return the current contents of the decompression buffer.
+ * Reads the currently selected archive member directly into a caller provided
+ * writable buffer, returning the number of bytes read. 0 will be returned when
+ * no more data is available.
  *
- * @return pybind11::bytes
+ * @return int
  */
-pybind11::bytes ArchiveReader::getChunk() {
-    return pybind11::bytes(this->chunk.data(), this->chunk.size());
+int ArchiveReader::readInto(pybind11::buffer buffer) {
+    pybind11::buffer_info info = buffer.request(true);
+    int result;
+
+    {
+        pybind11::gil_scoped_release release;
+        int64_t started = monotonicNanos();
+
+        result = archive_read_data(this->archive,
+                                   info.ptr,
+                                   info.size * info.itemsize);
+
+        this->readNanos += monotonicNanos() - started;
+    }
+
+    if (result < 0) {
+        throw ArchiveError();
+    }
+
+    this->bytesRead += result;
+
+    return result;
+}
+
+/**
+ * Reads the entire currently selected archive member into a reusable native
+ * buffer, returning a zero-copy view over its contents. This allows members
+ * to be scanned entirely in memory, without spooling them through a cache
+ * directory first.
+ *
+ * @return pybind11::memoryview
+ */
+pybind11::memoryview ArchiveReader::readMember() {
+    {
+        pybind11::gil_scoped_release release;
+        int64_t started = monotonicNanos();
+
+        this->member.clear();
+
+        // Size the buffer up front where the member size is known, to avoid
+        // repeated reallocation while accumulating.
+        if (archive_entry_size_is_set(this->entry)) {
+            this->member.reserve(archive_entry_size(this->entry));
+        }
+
+        size_t used = 0;
+
+        while (true) {
+            if (this->member.size() - used < CHUNK_SIZE) {
+                this->member.resize(used + CHUNK_SIZE);
+            }
+
+            int result = archive_read_data(this->archive,
+                                           this->member.data() + used,
+                                           CHUNK_SIZE);
+
+            if (result == 0) {
+                break;
+            }
+            if (result < 0) {
+                throw ArchiveError();
+            }
+
+            used += result;
+        }
+
+        this->member.resize(used);
+        this->bytesRead += used;
+        this->readNanos += monotonicNanos() - started;
+    }
+
+    return pybind11::memoryview::from_memory(this->member.data(),
+                                             this->member.size());
+}
+
+/**
+ * Extracts all members of the archive under the provided directory, returning
+ * the number of members extracted. Extraction is performed entirely natively
+ * to avoid crossing the Python boundary for every chunk of every member.
+ *
+ * Members whose leading bytes match an entry in the provided nested magic
+ * table are recursively unpacked in the same pass. Decompression budgets are
+ * enforced natively as members are streamed, with a value of zero disabling
+ * the corresponding check.
+ *
+ * Members matching the provided skip filters are bypassed per-header with a
+ * seek, so their payloads are never decompressed.
+ *
+ * @return int
+ */
+int ArchiveReader::extractAll(const std::string &directory,
+                              const std::vector<NestedMagic> &nested,
+                              la_int64_t max_member_size,
+                              la_int64_t max_total_size,
+                              la_int64_t max_ratio,
+                              la_int64_t skip_larger_than,
+                              const std::vector<std::string> &skip_patterns,
+                              bool regular_only) {
+    ExtractionFilters filters;
+    ExtractionLimits limits;
+
+    filters.larger_than = skip_larger_than;
+    filters.patterns = skip_patterns;
+    filters.regular_only = regular_only;
+
+    limits.member = max_member_size;
+    limits.total = max_total_size;
+    limits.ratio = max_ratio;
+
+    // No Python objects are touched inside of the extraction loop, so the GIL
+    // may be released for the duration.
+    pybind11::gil_scoped_release release;
+
+    ExtractionStats stats;
+    int64_t started = monotonicNanos();
+
+    int count = extractToDisk(this->archive,
+                              directory,
+                              nested,
+                              filters,
+                              limits,
+                              0,
+                              &stats);
+
+    this->readNanos += monotonicNanos() - started;
+    this->bytesRead += stats.produced;
+    this->membersVisited += stats.members;
+    this->unpackedDirs.insert(this->unpackedDirs.end(),
+                              stats.unpacked.begin(),
+                              stats.unpacked.end());
+
+    return count;
+}
+
+/**
+ * Return a zero-copy view over the decompression buffer, sized to the number
+ * of bytes read by the last call to read().
+ *
+ * @return pybind11::memoryview
+ */
+pybind11::memoryview ArchiveReader::getChunk() {
+    return pybind11::memoryview::from_memory(this->chunk.data(), this->filled);
 }
 
 /**
@@ -70,9 +266,15 @@ pybind11::bytes ArchiveReader::getChunk() {
  * @return ArchiveEntry
  */
 ArchiveEntry ArchiveReader::next() {
-    int result = archive_read_next_header(this->archive, &this->entry);
+    int result;
+
+    {
+        pybind11::gil_scoped_release release;
+        result = archive_read_next_header(this->archive, &this->entry);
+    }
 
     if (result == ARCHIVE_OK) {
+        this->membersVisited++;
         return ArchiveEntry(this->entry);
     }
     if (result == ARCHIVE_EOF) {
@@ -82,6 +284,66 @@ ArchiveEntry ArchiveReader::next() {
     throw ArchiveError();
 }
 
+/**
+ * Walks all remaining member headers in a single native loop, returning a
+ * snapshot of each. Member data is skipped, so this is suitable for cheap
+ * manifest-only listings of large archives.
+ *
+ * @return std::vector<ArchiveEntry>
+ */
+std::vector<ArchiveEntry> ArchiveReader::entries() {
+    pybind11::gil_scoped_release release;
+    std::vector<ArchiveEntry> members;
+
+    while (true) {
+        int result = archive_read_next_header(this->archive, &this->entry);
+
+        if (result == ARCHIVE_EOF) {
+            break;
+        }
+        if (result != ARCHIVE_OK && result != ARCHIVE_WARN) {
+            throw ArchiveError();
+        }
+
+        members.push_back(ArchiveEntry(this->entry));
+        this->membersVisited++;
+        archive_read_data_skip(this->archive);
+    }
+
+    return members;
+}
+
+/**
+ * Returns the telemetry counters accumulated by this reader as a dictionary.
+ * Byte counts cover decompressed output (bytes_read) and raw input consumed
+ * by the filter chain (bytes_consumed, finalised on close), with wall time
+ * split between the open and read phases in nanoseconds.
+ *
+ * @return pybind11::dict
+ */
+pybind11::dict ArchiveReader::getStats() {
+    pybind11::dict stats;
+
+    stats["bytes_read"] = this->bytesRead;
+    stats["bytes_consumed"] = this->bytesConsumed;
+    stats["members"] = this->membersVisited;
+    stats["open_ns"] = this->openNanos;
+    stats["read_ns"] = this->readNanos;
+
+    return stats;
+}
+
+/**
+ * Returns the directories produced by recursion into nested archives during
+ * extraction, so callers can distinguish them from archive members which
+ * merely share the naming convention.
+ *
+ * @return std::vector<std::string>
+ */
+std::vector<std::string> ArchiveReader::getUnpacked() {
+    return this->unpackedDirs;
+}
+
 /**
  * Loads an archive on Python Context Manager enter.
  *
@@ -90,14 +352,38 @@ ArchiveEntry ArchiveReader::next() {
 ArchiveReader *ArchiveReader::enter() {
     this->archive = archive_read_new();
 
-    // Enable all libarchive supported filters and formats.
-    archive_read_support_filter_all(this->archive);
-    archive_read_support_format_all(this->archive);
+    // Enable the filters and formats matching the caller's format hint, or
+    // everything where no hint was provided.
+    enableSupport(this->archive, this->format);
+
+    // Attempt to open the archive from the configured source - which may be a
+    // file on disk, a caller provided buffer, or an open file descriptor.
+    int result;
 
-    // Attempt to open the archive.
-    int result = archive_read_open_filename(this->archive,
-                                            this->filename.c_str(),
-                                            10240);
+    {
+        pybind11::gil_scoped_release release;
+        int64_t started = monotonicNanos();
+
+        switch (this->source) {
+            case SOURCE_MEMORY:
+                result = archive_read_open_memory(
+                    this->archive,
+                    this->buffer.ptr,
+                    this->buffer.size * this->buffer.itemsize);
+                break;
+            case SOURCE_DESCRIPTOR:
+                result = archive_read_open_fd(this->archive,
+                                              this->descriptor,
+                                              10240);
+                break;
+            default:
+                result = archive_read_open_filename(this->archive,
+                                                    this->filename.c_str(),
+                                                    10240);
+        }
+
+        this->openNanos += monotonicNanos() - started;
+    }
 
     if (result != ARCHIVE_OK) {
         throw ArchiveError();
@@ -114,6 +400,14 @@ ArchiveReader *ArchiveReader::enter() {
 bool ArchiveReader::exit(pybind11::object exc_type,
                          pybind11::object exc_value,
                          pybind11::object exc_traceback) {
+    // Snapshot the raw bytes consumed by the filter chain before the handle is
+    // freed, so it remains available from the stats property afterwards.
+    la_int64_t consumed = archive_filter_bytes(this->archive, -1);
+
+    if (consumed > 0) {
+        this->bytesConsumed = consumed;
+    }
+
     int result = archive_read_free(this->archive);
 
     if (result == ARCHIVE_OK) {
@@ -10,13 +10,17 @@
 #include <iostream>
 #include <string>
 
+#include "extractor.hpp"
+
 const int CHUNK_SIZE = 10240;
 
 class ArchiveEntry;
 
 class ArchiveReader {
    public:
-    ArchiveReader(const std::string &filename);
+    ArchiveReader(const std::string &filename, const std::string &format);
+    ArchiveReader(const pybind11::buffer &buffer);
+    ArchiveReader(int descriptor);
     ~ArchiveReader();
 
     ArchiveReader *enter();
@@ -25,18 +29,50 @@ class ArchiveReader {
               pybind11::object exc_traceback);
 
     int read();
+    int readInto(pybind11::buffer buffer);
+    pybind11::memoryview readMember();
+    int extractAll(const std::string &directory,
+                   const std::vector<NestedMagic> &nested,
+                   la_int64_t max_member_size,
+                   la_int64_t max_total_size,
+                   la_int64_t max_ratio,
+                   la_int64_t skip_larger_than,
+                   const std::vector<std::string> &skip_patterns,
+                   bool regular_only);
     ArchiveEntry next();
+    std::vector<ArchiveEntry> entries();
     ArchiveReader *iter();
     std::string getFilename();
-    pybind11::bytes getChunk();
+    pybind11::memoryview getChunk();
+    pybind11::dict getStats();
+    std::vector<std::string> getUnpacked();
 
    private:
+    enum Source { SOURCE_FILENAME, SOURCE_MEMORY, SOURCE_DESCRIPTOR };
+
+    void resetStats();
+
     std::vector<char> chunk;
+    std::vector<char> member;
+    int filled;
     std::string filename;
+    std::string format;
+    Source source;
+    pybind11::buffer_info buffer;
+    int descriptor;
     struct archive *archive;
     struct archive_entry *entry;
-};
 
-struct ArchiveError : std::exception {
-    const char *what() const noexcept;
+    // Always-on telemetry counters. These are plain per-instance fields - not
+    // atomics - as a reader is only ever driven from one thread at a time, so
+    // each update is a single uncontended add.
+    la_int64_t bytesRead;
+    la_int64_t bytesConsumed;
+    la_int64_t membersVisited;
+    la_int64_t openNanos;
+    la_int64_t readNanos;
+
+    // Directories produced by recursion into nested archives during
+    // extractAll, in the order they were created.
+    std::vector<std::string> unpackedDirs;
 };
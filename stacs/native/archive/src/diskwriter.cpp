@@ -0,0 +1,227 @@
+/**
+ * @file diskwriter.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "diskwriter.hpp"
+
+#include "extractor.hpp"
+
+// The number of data buffers which may be in flight at once. Two is
+// sufficient to overlap decompression with disk I/O: libarchive fills one
+// buffer while the writer thread drains the other.
+const size_t DATA_BUFFERS = 2;
+
+/**
+ * Starts the writer thread. The thread owns the write-disk handle for its
+ * entire lifetime, so all libarchive write calls happen off of the caller's
+ * thread.
+ */
+DiskWriter::DiskWriter() : broken(false), queued(0), busy(false), closed(false) {
+    this->thread = std::thread(&DiskWriter::worker, this);
+}
+
+DiskWriter::~DiskWriter() {
+    this->close();
+}
+
+/**
+ * Queues a command for the writer thread, blocking while the configured
+ * number of data buffers are already in flight. This bounds memory usage
+ * while still allowing decompression of the next block to overlap with the
+ * write of the previous one.
+ */
+void DiskWriter::submit(Command &command) {
+    {
+        std::unique_lock<std::mutex> guard(this->lock);
+
+        if (command.type == COMMAND_DATA) {
+            this->space.wait(guard,
+                             [this] { return this->queued < DATA_BUFFERS; });
+            this->queued++;
+        }
+
+        this->commands.push_back(std::move(command));
+    }
+
+    this->available.notify_one();
+}
+
+/**
+ * Queues the member header for writing. The entry is cloned, as libarchive
+ * reuses the reader's entry for every member.
+ */
+void DiskWriter::header(struct archive_entry *entry) {
+    Command command;
+
+    command.type = COMMAND_HEADER;
+    command.entry = archive_entry_clone(entry);
+    command.size = 0;
+    command.offset = 0;
+
+    this->submit(command);
+}
+
+/**
+ * Queues a data block for writing at the provided offset, copying it into a
+ * recycled buffer so that libarchive may immediately reuse its own.
+ */
+void DiskWriter::data(const void *block, size_t size, la_int64_t offset) {
+    Command command;
+
+    command.type = COMMAND_DATA;
+    command.entry = NULL;
+    command.size = size;
+    command.offset = offset;
+
+    {
+        std::unique_lock<std::mutex> guard(this->lock);
+
+        if (!this->spare.empty()) {
+            command.buffer = std::move(this->spare.front());
+            this->spare.pop_front();
+        }
+    }
+
+    // The copy is performed outside of the lock, so the writer thread is
+    // never stalled behind it.
+    command.buffer.assign((const char *)block, (const char *)block + size);
+
+    this->submit(command);
+}
+
+/**
+ * Queues completion of the current member, flushing metadata such as
+ * permissions and timestamps.
+ */
+void DiskWriter::finish() {
+    Command command;
+
+    command.type = COMMAND_FINISH;
+    command.entry = NULL;
+    command.size = 0;
+    command.offset = 0;
+
+    this->submit(command);
+}
+
+/**
+ * Blocks until every queued command has been processed. Used as a barrier
+ * before reading back a just-written member, such as when recursing into a
+ * nested archive.
+ */
+void DiskWriter::drain() {
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->space.wait(guard,
+                     [this] { return this->commands.empty() && !this->busy; });
+}
+
+/**
+ * Signals the writer thread to exit once the queue is empty, and waits for
+ * it to do so. Safe to call more than once.
+ */
+void DiskWriter::close() {
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        if (this->closed) {
+            return;
+        }
+
+        this->closed = true;
+    }
+
+    this->available.notify_all();
+    this->thread.join();
+}
+
+/**
+ * Checks whether any queued write has failed. Failures are sticky: once set,
+ * all subsequent writes are discarded.
+ *
+ * @return bool
+ */
+bool DiskWriter::failed() {
+    return this->broken;
+}
+
+/**
+ * The writer thread body. Owns the write-disk handle, consuming queued
+ * commands until closed. On write failure the broken flag is set and the
+ * remaining commands are consumed without effect, so the producer is never
+ * deadlocked waiting for buffer space.
+ */
+void DiskWriter::worker() {
+    struct archive *writer = archive_write_disk_new();
+    bool skipping = false;
+
+    // Data blocks are written at the offsets libarchive reports, so gaps in
+    // sparse-aware formats are seeked over rather than materialised as zeros.
+    // ARCHIVE_EXTRACT_SPARSE additionally detects runs of zeros in the data
+    // itself and punches holes in the output, which keeps mostly-empty disk
+    // images cheap to cache even when the format does not report sparseness.
+    archive_write_disk_set_options(
+        writer,
+        ARCHIVE_EXTRACT_SECURE_NODOTDOT | ARCHIVE_EXTRACT_SECURE_SYMLINKS |
+            ARCHIVE_EXTRACT_SPARSE);
+
+    while (true) {
+        Command command;
+
+        {
+            std::unique_lock<std::mutex> guard(this->lock);
+            this->available.wait(guard, [this] {
+                return !this->commands.empty() || this->closed;
+            });
+
+            if (this->commands.empty()) {
+                break;
+            }
+
+            command = std::move(this->commands.front());
+            this->commands.pop_front();
+            this->busy = true;
+        }
+
+        switch (command.type) {
+            case COMMAND_HEADER:
+                // Members whose headers cannot be written - such as those
+                // with unrepresentable types - are skipped in their entirety.
+                skipping = this->broken ||
+                           archive_write_header(writer, command.entry)
+                               != ARCHIVE_OK;
+                archive_entry_free(command.entry);
+                break;
+            case COMMAND_DATA:
+                if (!skipping && !this->broken &&
+                    archive_write_data_block(writer,
+                                             command.buffer.data(),
+                                             command.size,
+                                             command.offset) < ARCHIVE_OK) {
+                    this->broken = true;
+                }
+                break;
+            case COMMAND_FINISH:
+                if (!skipping && !this->broken) {
+                    archive_write_finish_entry(writer);
+                }
+                break;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+
+            if (command.type == COMMAND_DATA) {
+                this->spare.push_back(std::move(command.buffer));
+                this->queued--;
+            }
+
+            this->busy = false;
+        }
+
+        this->space.notify_all();
+    }
+
+    archive_write_free(writer);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file diskwriter.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+
+extern "C" {
+#include <archive.h>
+#include <archive_entry.h>
+}
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class DiskWriter {
+   public:
+    DiskWriter();
+    ~DiskWriter();
+
+    void header(struct archive_entry *entry);
+    void data(const void *block, size_t size, la_int64_t offset);
+    void finish();
+    void drain();
+    void close();
+    bool failed();
+
+   private:
+    enum CommandType { COMMAND_HEADER, COMMAND_DATA, COMMAND_FINISH };
+
+    struct Command {
+        CommandType type;
+        struct archive_entry *entry;
+        std::vector<char> buffer;
+        size_t size;
+        la_int64_t offset;
+    };
+
+    void submit(Command &command);
+    void worker();
+
+    std::thread thread;
+    std::deque<Command> commands;
+    std::deque<std::vector<char>> spare;
+    std::mutex lock;
+    std::condition_variable available;
+    std::condition_variable space;
+    std::atomic<bool> broken;
+    size_t queued;
+    bool busy;
+    bool closed;
+};
@@ -0,0 +1,413 @@
+/**
+ * @file extractor.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "extractor.hpp"
+
+#include <fnmatch.h>
+#include <string.h>
+
+#include "diskwriter.hpp"
+
+// The directory suffix used when unpacking archives found nested inside of
+// other archives. This must be kept in step with UNPACKED_ARCHIVE_SUFFIX in
+// stacs/scan/constants.py.
+const char *UNPACKED_SUFFIX = ".unpacked";
+
+// The maximum nesting depth to recurse through, protecting against archive
+// quines and other maliciously recursive inputs.
+const int MAX_NESTED_DEPTH = 8;
+
+// The number of decompressed bytes which must have been produced before the
+// compression ratio is checked, preventing small archives with legitimately
+// dense headers from tripping the ratio ceiling.
+const la_int64_t RATIO_CHECK_FLOOR = 1048576;
+
+const char *ArchiveError::what() const noexcept {
+    return "Unable to open archive for reading\n";
+}
+
+const char *ArchiveBombError::what() const noexcept {
+    return "Archive exceeded the configured decompression budget\n";
+}
+
+/**
+ * Checks whether the provided member prefix matches any of the nested archive
+ * magic entries.
+ *
+ * @return bool
+ */
+static bool matchesNestedMagic(const std::vector<char> &prefix,
+                               const std::vector<NestedMagic> &nested) {
+    for (const NestedMagic &magic : nested) {
+        if (magic.first + magic.second.size() > prefix.size()) {
+            continue;
+        }
+
+        if (memcmp(prefix.data() + magic.first,
+                   magic.second.data(),
+                   magic.second.size()) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Checks whether the provided member should be skipped without decompressing
+ * its payload, based on the configured extraction filters.
+ *
+ * @return bool
+ */
+static bool shouldSkipMember(struct archive_entry *entry,
+                             const std::string &member,
+                             const ExtractionFilters &filters) {
+    if (filters.larger_than && archive_entry_size_is_set(entry) &&
+        archive_entry_size(entry) > filters.larger_than) {
+        return true;
+    }
+
+    if (filters.regular_only) {
+        mode_t filetype = archive_entry_filetype(entry);
+
+        if (filetype != AE_IFREG && filetype != AE_IFDIR) {
+            return true;
+        }
+    }
+
+    for (const std::string &pattern : filters.patterns) {
+        if (fnmatch(pattern.c_str(), member.c_str(), 0) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Strips path components which could allow writes outside of the destination
+ * directory, returning the cleaned member path.
+ *
+ * @return std::string
+ */
+std::string sanitizeMemberPath(const char *pathname) {
+    std::string sanitized;
+
+    if (pathname == NULL) {
+        return sanitized;
+    }
+
+    // Rebuild the path component by component, dropping any empty, current
+    // directory, or parent directory components - as previously performed in
+    // Python.
+    std::string member(pathname);
+    std::string::size_type start = 0;
+
+    while (start <= member.size()) {
+        std::string::size_type end = member.find('/', start);
+
+        if (end == std::string::npos) {
+            end = member.size();
+        }
+
+        std::string component = member.substr(start, end - start);
+
+        if (component != "" && component != "." && component != "..") {
+            if (!sanitized.empty()) {
+                sanitized += "/";
+            }
+            sanitized += component;
+        }
+
+        start = end + 1;
+    }
+
+    return sanitized;
+}
+
+/**
+ * Enables read support on the provided handle for the format and filter
+ * matching the provided MIME type hint, avoiding the cost of every libarchive
+ * backend bidding on every open. Unknown or empty hints enable everything,
+ * leaving libarchive to bid as before.
+ */
+void enableSupport(struct archive *reader, const std::string &mime) {
+    if (mime == "application/x-tar") {
+        archive_read_support_format_tar(reader);
+    } else if (mime == "application/zip") {
+        archive_read_support_format_zip(reader);
+    } else if (mime == "application/x-iso9660-image") {
+        archive_read_support_format_iso9660(reader);
+    } else if (mime == "application/x-7z-compressed") {
+        archive_read_support_format_7zip(reader);
+    } else if (mime == "application/x-cpio") {
+        archive_read_support_format_cpio(reader);
+    } else if (mime == "application/x-xar") {
+        archive_read_support_format_xar(reader);
+    } else if (mime == "application/vnd.rar") {
+        archive_read_support_format_rar(reader);
+        archive_read_support_format_rar5(reader);
+    } else if (mime == "application/vnd.ms-cab-compressed") {
+        archive_read_support_format_cab(reader);
+    } else if (mime == "application/x-archive") {
+        archive_read_support_format_ar(reader);
+    } else if (mime == "application/gzip") {
+        // Compressed single-file payloads are handled by the Python
+        // fallback, so the only supported payload format here is tar.
+        archive_read_support_filter_gzip(reader);
+        archive_read_support_format_tar(reader);
+    } else if (mime == "application/x-bzip2") {
+        archive_read_support_filter_bzip2(reader);
+        archive_read_support_format_tar(reader);
+    } else if (mime == "application/x-xz") {
+        archive_read_support_filter_xz(reader);
+        archive_read_support_format_tar(reader);
+    } else if (mime == "application/zstd") {
+        archive_read_support_filter_zstd(reader);
+        archive_read_support_format_tar(reader);
+    } else {
+        archive_read_support_filter_all(reader);
+        archive_read_support_format_all(reader);
+    }
+}
+
+/**
+ * Extracts all members of an already open archive under the provided
+ * directory, returning the number of members extracted. This function does
+ * not touch any Python state, so it may be called with the GIL released, and
+ * from threads which have never held the GIL.
+ *
+ * Where nested archive magic entries are provided, members whose leading
+ * bytes match are recursively unpacked - in the same streaming pass - into a
+ * sibling directory named after the member with UNPACKED_SUFFIX appended.
+ *
+ * Decompressed bytes are counted against the provided limits as members are
+ * streamed, with extraction aborted as soon as any budget is exceeded. This
+ * bounds the worst-case cost of a decompression bomb without any per-chunk
+ * callbacks into Python.
+ *
+ * Extraction filters are evaluated against each header before any of the
+ * member's data is read, so filtered members cost a seek rather than
+ * decompression plus deletion.
+ *
+ * Disk writes are performed by a dedicated writer thread consuming a small
+ * ring of buffers, so decompression of the next block overlaps with the
+ * write of the previous one rather than running serially.
+ *
+ * @return int
+ */
+int extractToDisk(struct archive *reader,
+                  const std::string &directory,
+                  const std::vector<NestedMagic> &nested,
+                  const ExtractionFilters &filters,
+                  const ExtractionLimits &limits,
+                  int depth,
+                  ExtractionStats *stats) {
+    int count = 0;
+    la_int64_t total = 0;
+    struct archive_entry *entry;
+    DiskWriter writer;
+
+    // The prefix retained for nested archive detection only needs to cover
+    // the deepest magic offset provided.
+    size_t required = 0;
+
+    for (const NestedMagic &magic : nested) {
+        if (magic.first + magic.second.size() > required) {
+            required = magic.first + magic.second.size();
+        }
+    }
+
+    std::vector<char> prefix;
+    prefix.reserve(required);
+
+    while (true) {
+        int result = archive_read_next_header(reader, &entry);
+
+        if (result == ARCHIVE_EOF) {
+            break;
+        }
+        if (result != ARCHIVE_OK && result != ARCHIVE_WARN) {
+            throw ArchiveError();
+        }
+
+        // Members which sanitize down to nothing - such as '.' - are skipped.
+        std::string member = sanitizeMemberPath(archive_entry_pathname(entry));
+
+        if (member.empty() || shouldSkipMember(entry, member, filters)) {
+            archive_read_data_skip(reader);
+            continue;
+        }
+
+        // Hardlink targets recorded in the header would otherwise be passed
+        // to the disk writer unmodified, resolving relative to the process
+        // working directory - so they are sanitized and prefixed with the
+        // destination exactly as the member path is.
+        const char *hardlink = archive_entry_hardlink(entry);
+
+        if (hardlink != NULL) {
+            std::string target = sanitizeMemberPath(hardlink);
+
+            if (target.empty()) {
+                archive_read_data_skip(reader);
+                continue;
+            }
+
+            archive_entry_set_hardlink(entry,
+                                       (directory + "/" + target).c_str());
+        }
+
+        archive_entry_set_pathname(entry, (directory + "/" + member).c_str());
+        writer.header(entry);
+
+        bool regular = archive_entry_filetype(entry) == AE_IFREG;
+        la_int64_t produced = 0;
+        prefix.clear();
+
+        // Stream all data blocks for this member to the writer thread,
+        // capturing the leading bytes for nested archive detection as they
+        // pass.
+        const void *block;
+        size_t size;
+        la_int64_t offset;
+
+        while (true) {
+            result = archive_read_data_block(reader, &block, &size, &offset);
+
+            if (result == ARCHIVE_EOF) {
+                break;
+            }
+            if (result != ARCHIVE_OK && result != ARCHIVE_WARN) {
+                throw ArchiveError();
+            }
+
+            produced += size;
+            total += size;
+
+            if ((limits.member && produced > limits.member) ||
+                (limits.total && total > limits.total)) {
+                throw ArchiveBombError();
+            }
+
+            // The ratio of decompressed to compressed bytes is checked
+            // against the raw input consumed so far, which libarchive tracks
+            // at the end of the filter chain.
+            if (limits.ratio && total > RATIO_CHECK_FLOOR) {
+                la_int64_t consumed = archive_filter_bytes(reader, -1);
+
+                if (consumed > 0 && total / consumed > limits.ratio) {
+                    throw ArchiveBombError();
+                }
+            }
+
+            if (regular && prefix.size() < required &&
+                (size_t)offset == prefix.size()) {
+                size_t wanted = required - prefix.size();
+                size_t available = size < wanted ? size : wanted;
+                prefix.insert(prefix.end(),
+                              (const char *)block,
+                              (const char *)block + available);
+            }
+
+            writer.data(block, size, offset);
+
+            if (writer.failed()) {
+                throw ArchiveError();
+            }
+        }
+
+        writer.finish();
+        count++;
+
+        // Recurse into members which look like archives themselves, leaving
+        // anything which fails to open in place for the Python handlers.
+        if (regular && depth < MAX_NESTED_DEPTH &&
+            matchesNestedMagic(prefix, nested)) {
+            std::string target = directory + "/" + member;
+
+            // The member just written must be fully on disk before it can be
+            // opened for nested extraction.
+            writer.drain();
+
+            if (writer.failed()) {
+                throw ArchiveError();
+            }
+
+            try {
+                count += extractArchiveToDisk(target,
+                                              target + UNPACKED_SUFFIX,
+                                              nested,
+                                              filters,
+                                              limits,
+                                              depth + 1,
+                                              stats);
+
+                if (stats != NULL) {
+                    stats->unpacked.push_back(target + UNPACKED_SUFFIX);
+                }
+            } catch (const ArchiveError &) {
+                // Not a readable archive after all.
+            }
+        }
+    }
+
+    writer.close();
+
+    if (writer.failed()) {
+        throw ArchiveError();
+    }
+
+    if (stats != NULL) {
+        stats->produced += total;
+        stats->members += count;
+    }
+
+    return count;
+}
+
+/**
+ * Opens the archive at the provided path and extracts all members under the
+ * provided directory, returning the number of members extracted. Each call
+ * uses its own libarchive handle, so calls are safe to run concurrently.
+ *
+ * @return int
+ */
+int extractArchiveToDisk(const std::string &filename,
+                         const std::string &directory,
+                         const std::vector<NestedMagic> &nested,
+                         const ExtractionFilters &filters,
+                         const ExtractionLimits &limits,
+                         int depth,
+                         ExtractionStats *stats) {
+    struct archive *reader = archive_read_new();
+
+    archive_read_support_filter_all(reader);
+    archive_read_support_format_all(reader);
+
+    if (archive_read_open_filename(reader, filename.c_str(), 10240)
+        != ARCHIVE_OK) {
+        archive_read_free(reader);
+        throw ArchiveError();
+    }
+
+    int count;
+
+    try {
+        count = extractToDisk(reader,
+                              directory,
+                              nested,
+                              filters,
+                              limits,
+                              depth,
+                              stats);
+    } catch (...) {
+        archive_read_free(reader);
+        throw;
+    }
+
+    archive_read_free(reader);
+    return count;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file extractor.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+
+extern "C" {
+#include <archive.h>
+#include <archive_entry.h>
+}
+
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A nested archive magic entry: the offset of the magic in the member, and
+// the magic bytes themselves.
+typedef std::pair<size_t, std::string> NestedMagic;
+
+// Per-member filters evaluated against each header inside of the native
+// extraction loop. Members which match are skipped with
+// archive_read_data_skip, so their payloads are never decompressed.
+struct ExtractionFilters {
+    ExtractionFilters() : larger_than(0), regular_only(false) {}
+
+    // Skip members with a known decompressed size larger than this, in
+    // bytes. Zero disables the check.
+    la_int64_t larger_than;
+
+    // Skip members whose sanitized path matches any of these fnmatch(3)
+    // patterns.
+    std::vector<std::string> patterns;
+
+    // Skip members which are not regular files or directories, such as
+    // device nodes and FIFOs.
+    bool regular_only;
+};
+
+// Counters accumulated during extraction, for telemetry. Plain per-call
+// fields, so updates are a handful of adds per data block.
+struct ExtractionStats {
+    ExtractionStats() : produced(0), members(0) {}
+
+    // The number of decompressed bytes written out.
+    la_int64_t produced;
+
+    // The number of members extracted.
+    la_int64_t members;
+
+    // The directories produced by recursion into nested archives. Callers use
+    // this to distinguish directories this extractor created from archive
+    // members which merely share the naming convention.
+    std::vector<std::string> unpacked;
+};
+
+// Decompression budgets enforced inside of the native extraction loop. A
+// value of zero disables the corresponding check.
+struct ExtractionLimits {
+    ExtractionLimits() : member(0), total(0), ratio(0) {}
+
+    // The maximum decompressed size of a single member, in bytes.
+    la_int64_t member;
+
+    // The maximum decompressed size of the archive as a whole, in bytes.
+    la_int64_t total;
+
+    // The maximum ratio of decompressed to compressed bytes.
+    la_int64_t ratio;
+};
+
+struct ArchiveError : std::exception {
+    const char *what() const noexcept;
+};
+
+struct ArchiveBombError : std::exception {
+    const char *what() const noexcept;
+};
+
+std::string sanitizeMemberPath(const char *pathname);
+void enableSupport(struct archive *reader, const std::string &mime);
+int extractToDisk(struct archive *reader,
+                  const std::string &directory,
+                  const std::vector<NestedMagic> &nested,
+                  const ExtractionFilters &filters,
+                  const ExtractionLimits &limits,
+                  int depth,
+                  ExtractionStats *stats = NULL);
+int extractArchiveToDisk(const std::string &filename,
+                         const std::string &directory,
+                         const std::vector<NestedMagic> &nested,
+                         const ExtractionFilters &filters,
+                         const ExtractionLimits &limits,
+                         int depth,
+                         ExtractionStats *stats = NULL);
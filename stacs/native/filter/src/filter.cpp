@@ -0,0 +1,28 @@
+/**
+ * @file filter.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "ignorematcher.cpp"
+
+namespace py = pybind11;
+
+PYBIND11_MODULE(filter, module) {
+    module.doc() = "STACS Native Extensions for Finding Filters";
+    module.attr("__name__") = "stacs.native.filter";
+
+    py::class_<IgnoreMatcher>(module, "IgnoreMatcher")
+        // Compilation and matching operate on plain native structures, so
+        // the GIL is released for both.
+        .def(py::init<const std::vector<IgnoreRule> &>(),
+             py::call_guard<py::gil_scoped_release>())
+        .def("match",
+             &IgnoreMatcher::match,
+             py::call_guard<py::gil_scoped_release>())
+        .def("unsupported", &IgnoreMatcher::unsupported)
+        .doc() = "Matches findings against a compiled ignore list";
+}
@@ -0,0 +1,186 @@
+/**
+ * @file ignorematcher.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "ignorematcher.hpp"
+
+#include <algorithm>
+
+/**
+ * Compiles the provided ignore rules into an indexed form. Exact path and
+ * hash criteria are keyed into hash maps, and pattern criteria are compiled
+ * to regular expressions exactly once - rather than per finding. Patterns
+ * this engine cannot compile - such as those using Python specific regex
+ * constructs - are recorded rather than rejected, so the caller can evaluate
+ * them another way.
+ */
+IgnoreMatcher::IgnoreMatcher(const std::vector<IgnoreRule> &rules) {
+    for (size_t index = 0; index < rules.size(); index++) {
+        const std::string &path = std::get<0>(rules[index]);
+        const std::string &pattern = std::get<1>(rules[index]);
+        const std::string &md5 = std::get<2>(rules[index]);
+
+        Gate gate;
+        gate.module = std::get<3>(rules[index]);
+        gate.references = std::get<4>(rules[index]);
+        gate.offset = std::get<5>(rules[index]);
+
+        this->gates.push_back(gate);
+
+        if (!path.empty()) {
+            this->paths[path].push_back(index);
+        }
+
+        if (!md5.empty()) {
+            this->hashes[md5].push_back(index);
+        }
+
+        if (!pattern.empty()) {
+            try {
+                this->patterns.push_back(
+                    std::make_pair(index, std::regex(pattern)));
+            } catch (const std::regex_error &) {
+                this->incompatible.push_back(index);
+            }
+        }
+    }
+}
+
+/**
+ * Returns the indices of rules whose pattern this engine could not compile,
+ * in rule order.
+ *
+ * @return std::vector<size_t>
+ */
+std::vector<size_t> IgnoreMatcher::unsupported() {
+    return this->incompatible;
+}
+
+/**
+ * Checks the gating criteria shared by every rule type: the rule module must
+ * match, and where the rule lists references or an offset the finding must
+ * match those too.
+ *
+ * @return bool
+ */
+bool IgnoreMatcher::gateMatches(size_t rule,
+                                const std::string &module,
+                                const std::string &reference,
+                                int64_t offset) {
+    const Gate &gate = this->gates[rule];
+
+    if (gate.module != module) {
+        return false;
+    }
+
+    if (!gate.references.empty()) {
+        for (const std::string &candidate : gate.references) {
+            if (candidate == reference) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    if (gate.offset != -1) {
+        return gate.offset == offset;
+    }
+
+    return true;
+}
+
+/**
+ * Matches a single finding against the compiled rules, returning the index
+ * of the first rule which suppresses it, or -1. Rules are evaluated in their
+ * original order, with exact criteria resolved by hash lookup and only the
+ * pattern rules evaluated per finding.
+ *
+ * @return int
+ */
+int IgnoreMatcher::matchOne(const IgnoreCandidate &finding) {
+    const std::string &path = std::get<0>(finding);
+    const std::string &md5 = std::get<1>(finding);
+    const std::string &module = std::get<2>(finding);
+    const std::string &reference = std::get<3>(finding);
+    int64_t offset = std::get<4>(finding);
+
+    // Gather the rules whose exact path or hash criteria match this finding.
+    // Per-key index lists are in ascending rule order by construction.
+    std::vector<size_t> exact;
+
+    auto hit = this->paths.find(path);
+
+    if (hit != this->paths.end()) {
+        exact.insert(exact.end(), hit->second.begin(), hit->second.end());
+    }
+
+    if (!md5.empty()) {
+        hit = this->hashes.find(md5);
+
+        if (hit != this->hashes.end()) {
+            exact.insert(exact.end(), hit->second.begin(), hit->second.end());
+        }
+    }
+
+    std::sort(exact.begin(), exact.end());
+    exact.erase(std::unique(exact.begin(), exact.end()), exact.end());
+
+    // Walk the exact hits and the pattern rules interleaved in rule order,
+    // preserving the first-match semantics of the original per-rule loop. A
+    // rule may appear in both lists - a hash rule with a pattern - in which
+    // case the exact hit already satisfies its criterion.
+    size_t position = 0;
+    size_t candidate = 0;
+
+    while (position < exact.size() || candidate < this->patterns.size()) {
+        size_t rule;
+        bool matched;
+
+        if (candidate >= this->patterns.size() ||
+            (position < exact.size() &&
+             exact[position] <= this->patterns[candidate].first)) {
+            rule = exact[position];
+            matched = true;
+
+            if (candidate < this->patterns.size() &&
+                this->patterns[candidate].first == rule) {
+                candidate++;
+            }
+
+            position++;
+        } else {
+            rule = this->patterns[candidate].first;
+            matched = std::regex_search(path, this->patterns[candidate].second);
+            candidate++;
+        }
+
+        if (matched && this->gateMatches(rule, module, reference, offset)) {
+            return (int)rule;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Matches all provided findings against the compiled rules in one pass,
+ * returning the index of the suppressing rule for each - or -1 where the
+ * finding is not suppressed. This function does not touch any Python state,
+ * so it may be called with the GIL released.
+ *
+ * @return std::vector<int>
+ */
+std::vector<int> IgnoreMatcher::match(
+    const std::vector<IgnoreCandidate> &findings) {
+    std::vector<int> decisions;
+    decisions.reserve(findings.size());
+
+    for (const IgnoreCandidate &finding : findings) {
+        decisions.push_back(this->matchOne(finding));
+    }
+
+    return decisions;
+}
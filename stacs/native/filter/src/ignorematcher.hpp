@@ -0,0 +1,65 @@
+/**
+ * @file ignorematcher.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <regex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+// An ignore rule in compiled form: (path, pattern, md5, module, references,
+// offset). Unset string criteria are empty, and an unset offset is -1.
+typedef std::tuple<std::string,
+                   std::string,
+                   std::string,
+                   std::string,
+                   std::vector<std::string>,
+                   int64_t>
+    IgnoreRule;
+
+// A finding in matchable form: (path, md5, module, reference, offset). An
+// unset offset is -1.
+typedef std::tuple<std::string, std::string, std::string, std::string, int64_t>
+    IgnoreCandidate;
+
+class IgnoreMatcher {
+   public:
+    IgnoreMatcher(const std::vector<IgnoreRule> &rules);
+
+    std::vector<int> match(const std::vector<IgnoreCandidate> &findings);
+    std::vector<size_t> unsupported();
+
+   private:
+    // The gating criteria shared by every rule type, kept per rule index.
+    struct Gate {
+        std::string module;
+        std::vector<std::string> references;
+        int64_t offset;
+    };
+
+    bool gateMatches(size_t rule,
+                     const std::string &module,
+                     const std::string &reference,
+                     int64_t offset);
+    int matchOne(const IgnoreCandidate &finding);
+
+    std::vector<Gate> gates;
+
+    // Exact criteria are indexed by value, so only rules which can possibly
+    // match a finding are evaluated for it. Pattern rules are retained in
+    // rule order with their expressions compiled once.
+    std::unordered_map<std::string, std::vector<size_t>> paths;
+    std::unordered_map<std::string, std::vector<size_t>> hashes;
+    std::vector<std::pair<size_t, std::regex>> patterns;
+
+    // Indices of rules whose pattern this engine could not compile, in rule
+    // order. The caller is expected to evaluate these another way.
+    std::vector<size_t> incompatible;
+};
@@ -0,0 +1,36 @@
+/**
+ * @file digestindex.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "digestindex.hpp"
+
+/**
+ * Records the provided digest, returning whether this was its first
+ * occurrence. Safe to call from multiple threads concurrently.
+ *
+ * @return bool
+ */
+bool DigestIndex::insert(const std::string &digest) {
+    size_t shard = std::hash<std::string>()(digest) % DIGEST_INDEX_SHARDS;
+
+    std::lock_guard<std::mutex> guard(this->locks[shard]);
+    return this->shards[shard].insert(digest).second;
+}
+
+/**
+ * Returns the number of distinct digests recorded.
+ *
+ * @return size_t
+ */
+size_t DigestIndex::size() {
+    size_t total = 0;
+
+    for (size_t shard = 0; shard < DIGEST_INDEX_SHARDS; shard++) {
+        std::lock_guard<std::mutex> guard(this->locks[shard]);
+        total += this->shards[shard].size();
+    }
+
+    return total;
+}
@@ -0,0 +1,25 @@
+/**
+ * @file digestindex.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+// The number of shards in the index. Insertions only contend when their
+// digests land in the same shard.
+const size_t DIGEST_INDEX_SHARDS = 16;
+
+class DigestIndex {
+   public:
+    bool insert(const std::string &digest);
+    size_t size();
+
+   private:
+    std::unordered_set<std::string> shards[DIGEST_INDEX_SHARDS];
+    std::mutex locks[DIGEST_INDEX_SHARDS];
+};
@@ -0,0 +1,102 @@
+/**
+ * @file magicmatcher.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "magicmatcher.hpp"
+
+#include <string.h>
+
+/**
+ * Compiles the provided magic table into a dispatch structure. The original
+ * position of each rule in the table is retained so that, where multiple
+ * rules match, the first entry in the table still wins - as with the previous
+ * Python implementation.
+ */
+MagicMatcher::MagicMatcher(const std::vector<MagicRule> &rules) {
+    this->required_ = 0;
+
+    for (size_t order = 0; order < rules.size(); order++) {
+        const MagicRule &rule = rules[order];
+        size_t offset = std::get<1>(rule);
+
+        for (const std::string &magic : std::get<2>(rule)) {
+            if (magic.empty()) {
+                continue;
+            }
+
+            Candidate candidate;
+            candidate.mime = std::get<0>(rule);
+            candidate.offset = offset;
+            candidate.order = order;
+            candidate.magic = magic;
+
+            if (offset == 0) {
+                this->indexed[(unsigned char)magic[0]].push_back(candidate);
+            } else {
+                this->offsets.push_back(candidate);
+            }
+
+            if (offset + magic.size() > this->required_) {
+                this->required_ = offset + magic.size();
+            }
+        }
+    }
+}
+
+/**
+ * Matches the provided file prefix against the compiled table, returning the
+ * name of the matching MIME type - or an empty string if no rule matched.
+ *
+ * @return std::string
+ */
+std::string MagicMatcher::match(const char *data, size_t size) const {
+    if (size == 0) {
+        return std::string();
+    }
+
+    const Candidate *found = NULL;
+
+    for (const Candidate &candidate : this->indexed[(unsigned char)data[0]]) {
+        if (candidate.magic.size() > size) {
+            continue;
+        }
+
+        if (memcmp(data, candidate.magic.data(), candidate.magic.size()) == 0) {
+            found = &candidate;
+            break;
+        }
+    }
+
+    for (const Candidate &candidate : this->offsets) {
+        if (found != NULL && found->order < candidate.order) {
+            continue;
+        }
+        if (candidate.offset + candidate.magic.size() > size) {
+            continue;
+        }
+
+        if (memcmp(data + candidate.offset,
+                   candidate.magic.data(),
+                   candidate.magic.size()) == 0) {
+            found = &candidate;
+        }
+    }
+
+    if (found != NULL) {
+        return found->mime;
+    }
+
+    return std::string();
+}
+
+/**
+ * Returns the number of bytes of file prefix required to evaluate every rule
+ * in the compiled table.
+ *
+ * @return size_t
+ */
+size_t MagicMatcher::required() const {
+    return this->required_;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file magicmatcher.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+// A magic table entry, as produced by the Python loader: the MIME type name,
+// the offset of the magic in the file, and the candidate magic byte strings.
+typedef std::tuple<std::string, size_t, std::vector<std::string>> MagicRule;
+
+class MagicMatcher {
+   public:
+    MagicMatcher(const std::vector<MagicRule> &rules);
+
+    std::string match(const char *data, size_t size) const;
+    size_t required() const;
+
+   private:
+    struct Candidate {
+        std::string mime;
+        size_t offset;
+        size_t order;
+        std::string magic;
+    };
+
+    // Zero-offset candidates are indexed by their first byte, so matching
+    // only ever compares against candidates which could possibly match.
+    std::vector<Candidate> indexed[256];
+
+    // Candidates at a non-zero offset - such as tar and ISO9660 - are few,
+    // and are checked directly.
+    std::vector<Candidate> offsets;
+
+    size_t required_;
+};
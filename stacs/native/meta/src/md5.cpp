@@ -0,0 +1,150 @@
+/**
+ * @file md5.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "md5.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+MD5::MD5() {
+    this->state[0] = 0x67452301;
+    this->state[1] = 0xefcdab89;
+    this->state[2] = 0x98badcfe;
+    this->state[3] = 0x10325476;
+    this->count = 0;
+}
+
+/**
+ * Applies the MD5 compression function (RFC 1321) to a single 64-byte block.
+ */
+void MD5::transform(const unsigned char block[64]) {
+    static const uint32_t K[64] = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+        0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+        0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+        0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+        0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+        0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+        0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+        0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+        0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+    static const uint32_t S[64] = {
+        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+        5, 9,  14, 20, 5, 9,  14, 20, 5, 9,  14, 20, 5, 9,  14, 20,
+        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21};
+
+    uint32_t m[16];
+
+    for (int i = 0; i < 16; i++) {
+        m[i] = (uint32_t)block[i * 4] |
+               ((uint32_t)block[i * 4 + 1] << 8) |
+               ((uint32_t)block[i * 4 + 2] << 16) |
+               ((uint32_t)block[i * 4 + 3] << 24);
+    }
+
+    uint32_t a = this->state[0];
+    uint32_t b = this->state[1];
+    uint32_t c = this->state[2];
+    uint32_t d = this->state[3];
+
+    for (int i = 0; i < 64; i++) {
+        uint32_t f;
+        int g;
+
+        if (i < 16) {
+            f = (b & c) | (~b & d);
+            g = i;
+        } else if (i < 32) {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) % 16;
+        } else if (i < 48) {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) % 16;
+        } else {
+            f = c ^ (b | ~d);
+            g = (7 * i) % 16;
+        }
+
+        uint32_t temp = d;
+        uint32_t x = a + f + K[i] + m[g];
+
+        d = c;
+        c = b;
+        b = b + ((x << S[i]) | (x >> (32 - S[i])));
+        a = temp;
+    }
+
+    this->state[0] += a;
+    this->state[1] += b;
+    this->state[2] += c;
+    this->state[3] += d;
+}
+
+/**
+ * Feeds a chunk of data into the digest.
+ */
+void MD5::update(const unsigned char *data, size_t length) {
+    size_t index = (size_t)(this->count % 64);
+    size_t partial = 64 - index;
+    size_t i = 0;
+
+    this->count += length;
+
+    if (length >= partial) {
+        if (index) {
+            std::memcpy(this->buffer + index, data, partial);
+            this->transform(this->buffer);
+            i = partial;
+            index = 0;
+        }
+
+        for (; i + 63 < length; i += 64) {
+            this->transform(data + i);
+        }
+    }
+
+    std::memcpy(this->buffer + index, data + i, length - i);
+}
+
+/**
+ * Finalises the digest, returning the lower-case hexadecimal representation.
+ *
+ * @return std::string
+ */
+std::string MD5::hexdigest() {
+    unsigned char padding[64] = {0x80};
+    unsigned char length[8];
+    uint64_t bits = this->count * 8;
+
+    for (int i = 0; i < 8; i++) {
+        length[i] = (bits >> (8 * i)) & 0xFF;
+    }
+
+    size_t index = (size_t)(this->count % 64);
+    size_t pad = (index < 56) ? (56 - index) : (120 - index);
+
+    this->update(padding, pad);
+    this->update(length, 8);
+
+    char digest[33];
+
+    for (int i = 0; i < 16; i++) {
+        std::snprintf(&digest[i * 2],
+                      3,
+                      "%02x",
+                      (this->state[i / 4] >> ((i % 4) * 8)) & 0xFF);
+    }
+
+    return std::string(digest, 32);
+}
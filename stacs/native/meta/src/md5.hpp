@@ -0,0 +1,25 @@
+/**
+ * @file md5.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class MD5 {
+   public:
+    MD5();
+
+    void update(const unsigned char *data, size_t length);
+    std::string hexdigest();
+
+   private:
+    void transform(const unsigned char block[64]);
+
+    uint32_t state[4];
+    uint64_t count;
+    unsigned char buffer[64];
+};
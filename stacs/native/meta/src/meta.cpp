@@ -0,0 +1,63 @@
+/**
+ * @file meta.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "digestindex.cpp"
+#include "magicmatcher.cpp"
+#include "md5.cpp"
+#include "summary.cpp"
+#include "walker.cpp"
+
+namespace py = pybind11;
+
+PYBIND11_MODULE(meta, module) {
+    module.doc() = "STACS Native Extensions for file metadata";
+    module.attr("__name__") = "stacs.native.meta";
+
+    py::class_<MagicMatcher>(module, "MagicMatcher")
+        .def(py::init<const std::vector<MagicRule> &>())
+        .def(
+            "match",
+            [](const MagicMatcher &matcher, const py::buffer &chunk) {
+                py::buffer_info info = chunk.request();
+                return matcher.match(static_cast<const char *>(info.ptr),
+                                     info.size * info.itemsize);
+            })
+        .doc() = "Matches file magic against a compiled table of formats";
+
+    py::class_<FileSummary>(module, "FileSummary")
+        .def_readonly("path", &FileSummary::path)
+        .def_readonly("md5", &FileSummary::md5)
+        .def_readonly("mime", &FileSummary::mime)
+        .def_readonly("size", &FileSummary::size)
+        .def_readonly("binary", &FileSummary::binary)
+        .def_readonly("error", &FileSummary::error)
+        .doc() = "Represents the metadata of a single file";
+
+    module.def("summarize", &summarize);
+
+    py::class_<DigestIndex>(module, "DigestIndex")
+        .def(py::init<>())
+        .def("insert", &DigestIndex::insert)
+        .def("__len__", &DigestIndex::size)
+        .doc() = "A sharded concurrent set of content digests";
+
+    py::class_<WalkResult>(module, "WalkResult")
+        .def_readonly("files", &WalkResult::files)
+        .def_readonly("denied", &WalkResult::denied)
+        .def_readonly("failure", &WalkResult::failure)
+        .doc() = "The result of a recursive directory walk";
+
+    // The walk runs entirely on native threads, so the GIL is released for
+    // the duration.
+    module.def("walk",
+               &walk,
+               py::arg("path"),
+               py::arg("workers") = 4,
+               py::call_guard<py::gil_scoped_release>());
+}
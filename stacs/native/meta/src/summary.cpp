@@ -0,0 +1,171 @@
+/**
+ * @file summary.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "summary.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "md5.hpp"
+
+// The size of reads used when hashing files, deliberately larger than the
+// Python loader's CHUNK_SIZE to reduce syscall overhead.
+const size_t SUMMARY_READ_SIZE = 1048576;
+
+// The number of leading bytes inspected when classifying a file as binary or
+// text.
+const size_t CLASSIFY_SIZE = 65536;
+
+// The fraction of unexpected control bytes, as a divisor, above which a file
+// is classified as binary even if it decodes as UTF-8.
+const size_t CONTROL_DIVISOR = 16;
+
+/**
+ * Classifies the provided leading bytes of a file as binary or text. A file
+ * is considered binary if it contains a NUL, has a high density of control
+ * bytes outside of the usual whitespace set, or is not valid UTF-8. Sequences
+ * truncated by the classification window are not held against the file.
+ *
+ * @return bool
+ */
+static bool classifyBinary(const unsigned char *data, size_t size) {
+    size_t control = 0;
+    size_t cursor = 0;
+
+    while (cursor < size) {
+        unsigned char byte = data[cursor];
+
+        if (byte == 0x00) {
+            return true;
+        }
+
+        if (byte < 0x80) {
+            if (byte < 0x20 && byte != '\t' && byte != '\n' && byte != '\r' &&
+                byte != '\f' && byte != 0x1B) {
+                control++;
+            }
+
+            cursor++;
+            continue;
+        }
+
+        // Validate the multi-byte UTF-8 sequence, treating sequences cut off
+        // by the end of the window as valid.
+        size_t length;
+
+        if ((byte & 0xE0) == 0xC0) {
+            length = 2;
+        } else if ((byte & 0xF0) == 0xE0) {
+            length = 3;
+        } else if ((byte & 0xF8) == 0xF0) {
+            length = 4;
+        } else {
+            return true;
+        }
+
+        if (cursor + length > size) {
+            break;
+        }
+
+        for (size_t index = 1; index < length; index++) {
+            if ((data[cursor + index] & 0xC0) != 0x80) {
+                return true;
+            }
+        }
+
+        cursor += length;
+    }
+
+    return size > 0 && control > size / CONTROL_DIVISOR;
+}
+
+/**
+ * Generates a summary - MD5, size, and MIME type - for each of the provided
+ * paths in a single native pass, with the GIL released. Per-file failures are
+ * reported via the error field of the relevant summary, rather than aborting
+ * the batch.
+ *
+ * @return std::vector<FileSummary>
+ */
+std::vector<FileSummary> summarize(const std::vector<std::string> &paths,
+                                   const MagicMatcher &matcher) {
+    std::vector<FileSummary> summaries;
+    summaries.reserve(paths.size());
+
+    // The prefix retained for magic matching only needs to be as large as the
+    // deepest magic offset in the compiled table.
+    size_t required = matcher.required();
+
+    pybind11::gil_scoped_release release;
+
+    std::vector<char> buffer(SUMMARY_READ_SIZE);
+    std::vector<char> prefix;
+    prefix.reserve(required);
+
+    for (const std::string &path : paths) {
+        FileSummary summary;
+        summary.path = path;
+        summary.size = 0;
+        summary.binary = false;
+
+        int fd = open(path.c_str(), O_RDONLY);
+
+        if (fd < 0) {
+            summary.error = strerror(errno);
+            summaries.push_back(summary);
+            continue;
+        }
+
+        MD5 md5;
+        ssize_t bytes;
+        bool first = true;
+
+        prefix.clear();
+
+        while ((bytes = read(fd, buffer.data(), buffer.size())) > 0) {
+            md5.update(reinterpret_cast<unsigned char *>(buffer.data()),
+                       bytes);
+
+            // The binary / text classification only inspects the leading
+            // bytes of the file, which the first read already holds.
+            if (first) {
+                size_t window =
+                    (size_t)bytes < CLASSIFY_SIZE ? (size_t)bytes
+                                                  : CLASSIFY_SIZE;
+                summary.binary = classifyBinary(
+                    reinterpret_cast<unsigned char *>(buffer.data()), window);
+                first = false;
+            }
+
+            if (prefix.size() < required) {
+                size_t wanted = required - prefix.size();
+                size_t available = (size_t)bytes < wanted ? bytes : wanted;
+                prefix.insert(prefix.end(),
+                              buffer.data(),
+                              buffer.data() + available);
+            }
+
+            summary.size += bytes;
+        }
+
+        if (bytes < 0) {
+            summary.error = strerror(errno);
+            close(fd);
+            summaries.push_back(summary);
+            continue;
+        }
+
+        close(fd);
+
+        summary.md5 = md5.hexdigest();
+        summary.mime = matcher.match(prefix.data(), prefix.size());
+        summaries.push_back(summary);
+    }
+
+    return summaries;
+}
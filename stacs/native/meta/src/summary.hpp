@@ -0,0 +1,28 @@
+/**
+ * @file summary.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "magicmatcher.hpp"
+
+class FileSummary {
+   public:
+    std::string path;
+    std::string md5;
+    std::string mime;
+    std::string error;
+    int64_t size;
+    bool binary;
+};
+
+std::vector<FileSummary> summarize(const std::vector<std::string> &paths,
+                                   const MagicMatcher &matcher);
@@ -0,0 +1,196 @@
+/**
+ * @file walker.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "walker.hpp"
+
+#include <dirent.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Shared state for a single walk, drained by the worker threads.
+struct WalkContext {
+    std::deque<std::string> pending;
+    std::string root;
+    WalkResult result;
+    std::mutex lock;
+    std::condition_variable available;
+    int active;
+};
+
+/**
+ * Reads a single directory, appending regular files to the result and
+ * queueing subdirectories for other workers. Symbolic links are never
+ * followed, matching the Python walker this replaces.
+ */
+static void walkDirectory(WalkContext &context, const std::string &directory) {
+    DIR *handle = opendir(directory.c_str());
+
+    if (handle == NULL) {
+        std::lock_guard<std::mutex> guard(context.lock);
+
+        if (errno == EACCES) {
+            context.result.denied.push_back(directory);
+        } else if (directory == context.root) {
+            // The root path failing to open is an error for the caller,
+            // rather than a skippable condition.
+            context.result.failure = directory + ": " + strerror(errno);
+        }
+
+        // Other failures on paths discovered during the walk - such as too
+        // many levels of symlinks - are skipped, as before.
+        return;
+    }
+
+    std::vector<std::string> files;
+    std::vector<std::string> directories;
+    struct dirent *entry;
+
+    while ((entry = readdir(handle)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        std::string path = directory + "/" + entry->d_name;
+        unsigned char kind = entry->d_type;
+
+        // Filesystems which do not report types from readdir need an lstat,
+        // which also ensures symlinks are identified rather than followed.
+        if (kind == DT_UNKNOWN) {
+            struct stat status;
+
+            if (lstat(path.c_str(), &status) != 0) {
+                continue;
+            }
+
+            if (S_ISDIR(status.st_mode)) {
+                kind = DT_DIR;
+            } else if (S_ISREG(status.st_mode)) {
+                kind = DT_REG;
+            } else {
+                continue;
+            }
+        }
+
+        if (kind == DT_DIR) {
+            directories.push_back(path);
+        } else if (kind == DT_REG) {
+            files.push_back(path);
+        }
+    }
+
+    closedir(handle);
+
+    {
+        std::lock_guard<std::mutex> guard(context.lock);
+        context.result.files.insert(context.result.files.end(),
+                                    files.begin(),
+                                    files.end());
+        context.pending.insert(context.pending.end(),
+                               directories.begin(),
+                               directories.end());
+    }
+
+    if (!directories.empty()) {
+        context.available.notify_all();
+    }
+}
+
+/**
+ * The walk worker body. Workers pull directories from the shared queue until
+ * it is empty and no other worker is mid-directory - at which point no new
+ * work can appear.
+ */
+static void walkWorker(WalkContext &context) {
+    while (true) {
+        std::string directory;
+
+        {
+            std::unique_lock<std::mutex> guard(context.lock);
+            context.available.wait(guard, [&context] {
+                return !context.pending.empty() || context.active == 0;
+            });
+
+            if (context.pending.empty()) {
+                return;
+            }
+
+            directory = context.pending.front();
+            context.pending.pop_front();
+            context.active++;
+        }
+
+        walkDirectory(context, directory);
+
+        {
+            std::lock_guard<std::mutex> guard(context.lock);
+            context.active--;
+        }
+
+        // Wake any idle workers: either new directories were queued, or this
+        // may have been the last piece of work.
+        context.available.notify_all();
+    }
+}
+
+/**
+ * Recursively walks the provided path on a pool of native threads, returning
+ * all regular files found along with any directories which could not be read
+ * due to permissions. A path which is not a directory is returned as-is,
+ * matching the Python walker's handling of single-file inputs.
+ *
+ * @return WalkResult
+ */
+WalkResult walk(const std::string &path, int workers) {
+    WalkContext context;
+    context.active = 0;
+    context.root = path;
+
+    struct stat status;
+
+    // The root is resolved with stat rather than lstat, so a symlinked root
+    // is traversed - matching os.scandir in the Python walker this replaces.
+    // Symlinks discovered below the root are never followed. A root which
+    // cannot be stat'd at all is an error, rather than an empty result.
+    if (stat(path.c_str(), &status) != 0) {
+        if (errno == EACCES) {
+            context.result.denied.push_back(path);
+        } else {
+            context.result.failure = path + ": " + strerror(errno);
+        }
+
+        return context.result;
+    }
+
+    // Single file inputs are returned directly, without a walk.
+    if (!S_ISDIR(status.st_mode)) {
+        context.result.files.push_back(path);
+        return context.result;
+    }
+
+    context.pending.push_back(path);
+
+    if (workers < 1) {
+        workers = 1;
+    }
+
+    std::vector<std::thread> threads;
+
+    for (int index = 0; index < workers; index++) {
+        threads.push_back(std::thread(walkWorker, std::ref(context)));
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    return context.result;
+}
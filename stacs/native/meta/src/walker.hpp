@@ -0,0 +1,22 @@
+/**
+ * @file walker.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// The result of a directory walk: every regular file found, and any
+// directories which could not be read due to permissions. Where the root path
+// itself cannot be stat'd or opened, failure describes the error - a broken
+// root is an error for the caller, not a skippable condition.
+struct WalkResult {
+    std::vector<std::string> files;
+    std::vector<std::string> denied;
+    std::string failure;
+};
+
+WalkResult walk(const std::string &path, int workers);
@@ -0,0 +1,210 @@
+/**
+ * @file jsonencoder.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "jsonencoder.hpp"
+
+#include <stdio.h>
+
+#include <string>
+
+// The initial size of the encoding buffer. Grown geometrically by std::string
+// where a document exceeds it, but large enough that a typical SARIF result
+// encodes without any reallocation.
+const size_t ENCODE_RESERVE = 16384;
+
+// The maximum depth of nested containers, guarding against reference cycles.
+const int MAX_ENCODE_DEPTH = 128;
+
+static void encodeValue(PyObject *object, std::string &buffer, int depth);
+
+/**
+ * Encodes a Python string into the buffer as a JSON string, escaping directly
+ * from the UTF-8 representation. Non-ASCII characters are emitted as raw
+ * UTF-8, which is valid JSON, rather than \u escapes.
+ */
+static void encodeString(PyObject *object, std::string &buffer) {
+    Py_ssize_t size;
+    const char *data = PyUnicode_AsUTF8AndSize(object, &size);
+
+    if (data == NULL) {
+        throw pybind11::error_already_set();
+    }
+
+    buffer += '"';
+
+    for (Py_ssize_t index = 0; index < size; index++) {
+        unsigned char byte = data[index];
+
+        switch (byte) {
+            case '"':
+                buffer += "\\\"";
+                break;
+            case '\\':
+                buffer += "\\\\";
+                break;
+            case '\n':
+                buffer += "\\n";
+                break;
+            case '\r':
+                buffer += "\\r";
+                break;
+            case '\t':
+                buffer += "\\t";
+                break;
+            case '\b':
+                buffer += "\\b";
+                break;
+            case '\f':
+                buffer += "\\f";
+                break;
+            default:
+                if (byte < 0x20) {
+                    char escape[8];
+                    snprintf(escape, sizeof(escape), "\\u%04x", byte);
+                    buffer += escape;
+                } else {
+                    buffer += (char)byte;
+                }
+        }
+    }
+
+    buffer += '"';
+}
+
+/**
+ * Appends the str() of the provided object to the buffer - used for integers,
+ * where the decimal representation is already JSON.
+ */
+static void encodeStr(PyObject *object, std::string &buffer) {
+    PyObject *text = PyObject_Str(object);
+
+    if (text == NULL) {
+        throw pybind11::error_already_set();
+    }
+
+    Py_ssize_t size;
+    const char *data = PyUnicode_AsUTF8AndSize(text, &size);
+
+    if (data == NULL) {
+        Py_DECREF(text);
+        throw pybind11::error_already_set();
+    }
+
+    buffer.append(data, size);
+    Py_DECREF(text);
+}
+
+/**
+ * Encodes a single Python object into the buffer, recursing into containers.
+ */
+static void encodeValue(PyObject *object, std::string &buffer, int depth) {
+    if (depth > MAX_ENCODE_DEPTH) {
+        throw pybind11::value_error("Maximum JSON encoding depth exceeded");
+    }
+
+    if (object == Py_None) {
+        buffer += "null";
+        return;
+    }
+
+    // Booleans are a subtype of int, so must be checked first.
+    if (PyBool_Check(object)) {
+        buffer += (object == Py_True) ? "true" : "false";
+        return;
+    }
+
+    if (PyUnicode_Check(object)) {
+        encodeString(object, buffer);
+        return;
+    }
+
+    if (PyLong_Check(object)) {
+        encodeStr(object, buffer);
+        return;
+    }
+
+    if (PyFloat_Check(object)) {
+        char *text = PyOS_double_to_string(PyFloat_AS_DOUBLE(object),
+                                           'r',
+                                           0,
+                                           Py_DTSF_ADD_DOT_0,
+                                           NULL);
+
+        if (text == NULL) {
+            throw pybind11::error_already_set();
+        }
+
+        buffer += text;
+        PyMem_Free(text);
+        return;
+    }
+
+    if (PyDict_Check(object)) {
+        PyObject *key;
+        PyObject *value;
+        Py_ssize_t position = 0;
+        bool first = true;
+
+        buffer += '{';
+
+        while (PyDict_Next(object, &position, &key, &value)) {
+            if (!PyUnicode_Check(key)) {
+                throw pybind11::type_error(
+                    "JSON object keys must be strings");
+            }
+
+            if (!first) {
+                buffer += ',';
+            }
+
+            encodeString(key, buffer);
+            buffer += ':';
+            encodeValue(value, buffer, depth + 1);
+            first = false;
+        }
+
+        buffer += '}';
+        return;
+    }
+
+    if (PyList_Check(object) || PyTuple_Check(object)) {
+        Py_ssize_t size = PySequence_Fast_GET_SIZE(object);
+
+        buffer += '[';
+
+        for (Py_ssize_t index = 0; index < size; index++) {
+            if (index) {
+                buffer += ',';
+            }
+
+            encodeValue(PySequence_Fast_GET_ITEM(object, index),
+                        buffer,
+                        depth + 1);
+        }
+
+        buffer += ']';
+        return;
+    }
+
+    throw pybind11::type_error("Unable to encode object as JSON");
+}
+
+/**
+ * Encodes the provided Python object as a UTF-8 JSON document, returned as
+ * bytes. Encoding is performed in a single pass into one preallocated buffer,
+ * with string escaping applied directly to the UTF-8 representation - there
+ * are no intermediate Python objects per value, as with json.dumps.
+ *
+ * @return pybind11::bytes
+ */
+pybind11::bytes encode(pybind11::handle object) {
+    std::string buffer;
+    buffer.reserve(ENCODE_RESERVE);
+
+    encodeValue(object.ptr(), buffer, 0);
+
+    return pybind11::bytes(buffer);
+}
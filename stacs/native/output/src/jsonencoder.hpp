@@ -0,0 +1,10 @@
+/**
+ * @file jsonencoder.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+#include <pybind11/pybind11.h>
+
+pybind11::bytes encode(pybind11::handle object);
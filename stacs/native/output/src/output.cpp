@@ -0,0 +1,22 @@
+/**
+ * @file output.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include <pybind11/pybind11.h>
+
+#include "jsonencoder.cpp"
+
+namespace py = pybind11;
+
+PYBIND11_MODULE(output, module) {
+    module.doc() = "STACS Native Extensions for Output Generation";
+    module.attr("__name__") = "stacs.native.output";
+
+    // The encoder operates on Python objects throughout, so the GIL is held.
+    module.def("encode",
+               &encode,
+               py::arg("object"),
+               "Encodes the provided object as a UTF-8 JSON document (bytes)");
+}
@@ -0,0 +1,94 @@
+/**
+ * @file lineindex.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "lineindex.hpp"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+const char *ScannerError::what() const noexcept {
+    return "Unable to open file for scanning\n";
+}
+
+/**
+ * Builds a sorted index of newline offsets for the file at the provided path
+ * in a single pass. The file is mapped rather than read, and newlines are
+ * located with memchr - which libc vectorizes - so the scan runs at memory
+ * bandwidth rather than byte-at-a-time.
+ */
+LineIndex::LineIndex(const std::string &filename) {
+    int descriptor = open(filename.c_str(), O_RDONLY);
+
+    if (descriptor < 0) {
+        throw ScannerError();
+    }
+
+    struct stat status;
+
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        throw ScannerError();
+    }
+
+    if (status.st_size == 0) {
+        close(descriptor);
+        return;
+    }
+
+    char *data = (char *)mmap(NULL,
+                              status.st_size,
+                              PROT_READ,
+                              MAP_PRIVATE,
+                              descriptor,
+                              0);
+
+    if (data == MAP_FAILED) {
+        close(descriptor);
+        throw ScannerError();
+    }
+
+    const char *cursor = data;
+    const char *end = data + status.st_size;
+
+    while (cursor < end) {
+        const char *found = (const char *)memchr(cursor, '\n', end - cursor);
+
+        if (found == NULL) {
+            break;
+        }
+
+        this->newlines.push_back(found - data);
+        cursor = found + 1;
+    }
+
+    munmap(data, status.st_size);
+    close(descriptor);
+}
+
+/**
+ * Resolves a byte offset to a one-based line number by binary search over the
+ * newline index.
+ *
+ * @return int
+ */
+int LineIndex::lineNumber(size_t offset) const {
+    return std::lower_bound(this->newlines.begin(), this->newlines.end(), offset)
+           - this->newlines.begin() + 1;
+}
+
+/**
+ * Returns the number of newlines in the indexed file.
+ *
+ * @return size_t
+ */
+size_t LineIndex::lines() const {
+    return this->newlines.size();
+}
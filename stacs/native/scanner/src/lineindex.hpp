@@ -0,0 +1,26 @@
+/**
+ * @file lineindex.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+
+#include <exception>
+#include <string>
+#include <vector>
+
+struct ScannerError : std::exception {
+    const char *what() const noexcept;
+};
+
+class LineIndex {
+   public:
+    LineIndex(const std::string &filename);
+
+    int lineNumber(size_t offset) const;
+    size_t lines() const;
+
+   private:
+    std::vector<size_t> newlines;
+};
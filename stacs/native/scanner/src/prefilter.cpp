@@ -0,0 +1,154 @@
+/**
+ * @file prefilter.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "prefilter.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <deque>
+
+/**
+ * Compiles the provided literal atoms into a dense Aho-Corasick automaton.
+ * Construction is the classic trie plus failure-link BFS, with the failure
+ * transitions folded into the transition table so the scan loop is a single
+ * table lookup per input byte.
+ */
+Prefilter::Prefilter(const std::vector<std::string> &atoms) {
+    this->transitions.push_back(std::vector<int>(256, -1));
+    this->terminal.push_back(false);
+
+    // Build the trie.
+    for (const std::string &atom : atoms) {
+        int state = 0;
+
+        for (unsigned char byte : atom) {
+            if (this->transitions[state][byte] < 0) {
+                this->transitions[state][byte] = this->transitions.size();
+                this->transitions.push_back(std::vector<int>(256, -1));
+                this->terminal.push_back(false);
+            }
+
+            state = this->transitions[state][byte];
+        }
+
+        if (state != 0) {
+            this->terminal[state] = true;
+        }
+    }
+
+    // Fold failure links into the transition table (BFS order).
+    std::vector<int> failure(this->transitions.size(), 0);
+    std::deque<int> queue;
+
+    for (int byte = 0; byte < 256; byte++) {
+        int next = this->transitions[0][byte];
+
+        if (next < 0) {
+            this->transitions[0][byte] = 0;
+        } else {
+            queue.push_back(next);
+        }
+    }
+
+    while (!queue.empty()) {
+        int state = queue.front();
+        queue.pop_front();
+
+        if (this->terminal[failure[state]]) {
+            this->terminal[state] = true;
+        }
+
+        for (int byte = 0; byte < 256; byte++) {
+            int next = this->transitions[state][byte];
+
+            if (next < 0) {
+                this->transitions[state][byte] =
+                    this->transitions[failure[state]][byte];
+            } else {
+                failure[next] = this->transitions[failure[state]][byte];
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+/**
+ * Checks whether the provided bytes contain any of the compiled atoms.
+ *
+ * @return bool
+ */
+bool Prefilter::containsAny(const char *data, size_t size) const {
+    int state = 0;
+
+    for (size_t cursor = 0; cursor < size; cursor++) {
+        state = this->transitions[state][(unsigned char)data[cursor]];
+
+        if (this->terminal[state]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Scans each of the provided files, returning for each whether it contains
+ * any of the compiled atoms. Files are mapped rather than read, and files
+ * which cannot be opened are reported as containing a match - so that the
+ * error surfaces from the scanner proper, exactly as before.
+ *
+ * @return std::vector<bool>
+ */
+std::vector<bool> Prefilter::filter(const std::vector<std::string> &paths) const {
+    std::vector<bool> hits;
+    hits.reserve(paths.size());
+
+    for (const std::string &path : paths) {
+        int descriptor = open(path.c_str(), O_RDONLY);
+
+        if (descriptor < 0) {
+            hits.push_back(true);
+            continue;
+        }
+
+        struct stat status;
+
+        if (fstat(descriptor, &status) != 0) {
+            close(descriptor);
+            hits.push_back(true);
+            continue;
+        }
+
+        if (status.st_size == 0) {
+            close(descriptor);
+            hits.push_back(false);
+            continue;
+        }
+
+        char *data = (char *)mmap(NULL,
+                                  status.st_size,
+                                  PROT_READ,
+                                  MAP_PRIVATE,
+                                  descriptor,
+                                  0);
+
+        if (data == MAP_FAILED) {
+            close(descriptor);
+            hits.push_back(true);
+            continue;
+        }
+
+        hits.push_back(this->containsAny(data, status.st_size));
+
+        munmap(data, status.st_size);
+        close(descriptor);
+    }
+
+    return hits;
+}
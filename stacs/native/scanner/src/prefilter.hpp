@@ -0,0 +1,24 @@
+/**
+ * @file prefilter.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+class Prefilter {
+   public:
+    Prefilter(const std::vector<std::string> &atoms);
+
+    bool containsAny(const char *data, size_t size) const;
+    std::vector<bool> filter(const std::vector<std::string> &paths) const;
+
+   private:
+    // A dense Aho-Corasick automaton: one row of byte transitions per state,
+    // with terminal states marking the end of any atom.
+    std::vector<std::vector<int>> transitions;
+    std::vector<bool> terminal;
+};
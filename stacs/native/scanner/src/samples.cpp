@@ -0,0 +1,153 @@
+/**
+ * @file samples.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include "samples.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lineindex.hpp"
+
+/**
+ * Checks whether the provided bytes are valid UTF-8.
+ *
+ * @return bool
+ */
+static bool validUtf8(const unsigned char *data, size_t size) {
+    size_t cursor = 0;
+
+    while (cursor < size) {
+        unsigned char lead = data[cursor];
+        size_t length;
+        unsigned int code;
+
+        if (lead < 0x80) {
+            cursor++;
+            continue;
+        } else if ((lead & 0xE0) == 0xC0) {
+            length = 2;
+            code = lead & 0x1F;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            code = lead & 0x0F;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4;
+            code = lead & 0x07;
+        } else {
+            return false;
+        }
+
+        if (cursor + length > size) {
+            return false;
+        }
+
+        for (size_t index = 1; index < length; index++) {
+            if ((data[cursor + index] & 0xC0) != 0x80) {
+                return false;
+            }
+            code = (code << 6) | (data[cursor + index] & 0x3F);
+        }
+
+        // Reject overlong encodings, surrogates, and out of range values.
+        if ((length == 2 && code < 0x80) || (length == 3 && code < 0x800) ||
+            (length == 4 && code < 0x10000) ||
+            (code >= 0xD800 && code <= 0xDFFF) || code > 0x10FFFF) {
+            return false;
+        }
+
+        cursor += length;
+    }
+
+    return true;
+}
+
+/**
+ * Extracts the context windows for all of the provided (offset, size) spans
+ * in a single pass, using one mapping of the file and copying out only the
+ * windows themselves. Windows are clamped to the bounds of the file, and each
+ * is classified as text where all three components are valid UTF-8.
+ *
+ * @return std::vector<SampleWindow>
+ */
+std::vector<SampleWindow> sampleWindows(
+    const std::string &filename,
+    const std::vector<std::pair<size_t, size_t>> &spans,
+    size_t window) {
+    std::vector<SampleWindow> samples;
+
+    int descriptor = open(filename.c_str(), O_RDONLY);
+
+    if (descriptor < 0) {
+        throw ScannerError();
+    }
+
+    struct stat status;
+
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        throw ScannerError();
+    }
+
+    size_t filesize = status.st_size;
+    char *data = NULL;
+
+    if (filesize > 0) {
+        data = (char *)mmap(NULL,
+                            filesize,
+                            PROT_READ,
+                            MAP_PRIVATE,
+                            descriptor,
+                            0);
+
+        if (data == MAP_FAILED) {
+            close(descriptor);
+            throw ScannerError();
+        }
+    }
+
+    for (const std::pair<size_t, size_t> &span : spans) {
+        SampleWindow sample;
+
+        size_t offset = span.first < filesize ? span.first : filesize;
+        size_t size = span.second;
+
+        if (offset + size > filesize) {
+            size = filesize - offset;
+        }
+
+        size_t before = offset < window ? offset : window;
+        size_t after = filesize - (offset + size);
+
+        if (after > window) {
+            after = window;
+        }
+
+        if (data != NULL) {
+            sample.before.assign(data + offset - before, before);
+            sample.match.assign(data + offset, size);
+            sample.after.assign(data + offset + size, after);
+        }
+
+        sample.text =
+            validUtf8((const unsigned char *)sample.before.data(),
+                      sample.before.size()) &&
+            validUtf8((const unsigned char *)sample.match.data(),
+                      sample.match.size()) &&
+            validUtf8((const unsigned char *)sample.after.data(),
+                      sample.after.size());
+
+        samples.push_back(sample);
+    }
+
+    if (data != NULL) {
+        munmap(data, filesize);
+    }
+
+    close(descriptor);
+    return samples;
+}
@@ -0,0 +1,25 @@
+/**
+ * @file samples.hpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// A context window around a single finding: the bytes before the match, the
+// match itself, and the bytes after - plus whether all three are valid UTF-8.
+struct SampleWindow {
+    std::string before;
+    std::string match;
+    std::string after;
+    bool text;
+};
+
+std::vector<SampleWindow> sampleWindows(
+    const std::string &filename,
+    const std::vector<std::pair<size_t, size_t>> &spans,
+    size_t window);
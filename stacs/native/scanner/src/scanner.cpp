@@ -0,0 +1,61 @@
+/**
+ * @file scanner.cpp
+ * @author Peter Adkins
+ * @date 2026-08-28
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "lineindex.cpp"
+#include "prefilter.cpp"
+#include "samples.cpp"
+
+namespace py = pybind11;
+
+PYBIND11_MODULE(scanner, module) {
+    module.doc() = "STACS Native Extensions for Scanning";
+    module.attr("__name__") = "stacs.native.scanner";
+
+    py::class_<LineIndex>(module, "LineIndex")
+        // The index is built on construction, which may scan a large file, so
+        // the GIL is released for the duration.
+        .def(py::init<const std::string &>(),
+             py::call_guard<py::gil_scoped_release>())
+        .def("line_number", &LineIndex::lineNumber)
+        .def_property_readonly("lines", &LineIndex::lines)
+        .doc() = "A sorted newline-offset index for line number resolution";
+
+    py::class_<SampleWindow>(module, "SampleWindow")
+        // The window contents are returned as bytes, as they may not be valid
+        // UTF-8 - the text property reports whether they are.
+        .def_property_readonly(
+            "before",
+            [](const SampleWindow &sample) { return py::bytes(sample.before); })
+        .def_property_readonly(
+            "match",
+            [](const SampleWindow &sample) { return py::bytes(sample.match); })
+        .def_property_readonly(
+            "after",
+            [](const SampleWindow &sample) { return py::bytes(sample.after); })
+        .def_readonly("text", &SampleWindow::text)
+        .doc() = "The context windows around a single finding";
+
+    py::class_<Prefilter>(module, "Prefilter")
+        .def(py::init<const std::vector<std::string> &>())
+        // Filtering scans whole files, so the GIL is released for the
+        // duration of the batch.
+        .def("filter",
+             &Prefilter::filter,
+             py::call_guard<py::gil_scoped_release>())
+        .doc() = "An Aho-Corasick prefilter over literal rule atoms";
+
+    module.def("sample_windows",
+               &sampleWindows,
+               py::arg("filename"),
+               py::arg("spans"),
+               py::arg("window"),
+               py::call_guard<py::gil_scoped_release>());
+
+    py::register_exception<ScannerError>(module, "ScannerError");
+}
@@ -11,3 +11,4 @@ from stacs.scan import loader  # noqa:F401
 from stacs.scan import model  # noqa:F401
 from stacs.scan import output  # noqa:F401
 from stacs.scan import scanner  # noqa:F401
+from stacs.scan import telemetry  # noqa:F401
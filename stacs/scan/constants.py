@@ -6,6 +6,9 @@ SPDX-License-Identifier: BSD-3-Clause
 # The size of chunks to use when reading files.
 CHUNK_SIZE = 65536
 
+# The number of files to pass to the native metadata engine per call.
+METADATA_BATCH_SIZE = 256
+
 # The size, in bytes, of the sample window.
 WINDOW_SIZE = 20
 
@@ -16,6 +19,29 @@ CACHE_DIRECTORY = "/tmp"
 # archives.
 ARCHIVE_FILE_SEPARATOR = "!"
 
+# The directory suffix used by the native extractor when recursively unpacking nested
+# archives. This must be kept in step with UNPACKED_SUFFIX in the native extension.
+UNPACKED_ARCHIVE_SUFFIX = ".unpacked"
+
+# The maximum decompressed size of a single archive member, in bytes (16GiB). Members
+# larger than this are treated as decompression bombs, and extraction is aborted.
+ARCHIVE_MAXIMUM_MEMBER_SIZE = 17179869184
+
+# The maximum decompressed size of an archive as a whole, in bytes (64GiB).
+ARCHIVE_MAXIMUM_TOTAL_SIZE = 68719476736
+
+# The maximum ratio of decompressed to compressed bytes. DEFLATE tops out at roughly
+# 1032:1, so anything beyond this is overwhelmingly likely to be a bomb.
+ARCHIVE_MAXIMUM_COMPRESSION_RATIO = 4096
+
+# Archive members larger than this, in bytes, are skipped at extraction time - before
+# any of their data is decompressed. Zero disables the check.
+ARCHIVE_SKIP_MEMBER_LARGER_THAN = 0
+
+# Archive members whose paths match any of these fnmatch-style patterns are skipped at
+# extraction time.
+ARCHIVE_SKIP_MEMBER_PATTERNS = []
+
 # Define an exit code to use when there are unsuppressed findings.
 EXIT_CODE_UNSUPPRESSED = 100
 
@@ -44,6 +44,15 @@ def unlink_error(function: Callable, path: str, exc_info: TracebackType):
     help="The number of threads to use when processing files",
     default=10,
 )
+@click.option(
+    "--processes",
+    help=(
+        "The number of processes to scan with. When greater than one, rule matching "
+        "runs in a process pool rather than threads, sidestepping the GIL on large "
+        "hosts."
+    ),
+    default=0,
+)
 @click.option(
     "--rule-pack",
     help="The path to the rule pack to load.",
@@ -63,15 +72,39 @@ def unlink_error(function: Callable, path: str, exc_info: TracebackType):
     help="The path to use as a cache - used when unpacking archives.",
     default=stacs.scan.constants.CACHE_DIRECTORY,
 )
+@click.option(
+    "--scan-cache",
+    help=(
+        "The path to a persistent scan cache, enabling incremental scans where "
+        "unchanged content is not re-scanned."
+    ),
+)
+@click.option(
+    "--timings",
+    help="Print a summary of where time was spent at the end of the run.",
+    is_flag=True,
+)
+@click.option(
+    "--output",
+    help=(
+        "The path to write the SARIF document to, rather than STDOUT. The document "
+        "is streamed to the file as findings are rendered, so memory use does not "
+        "grow with the number of findings."
+    ),
+)
 @click.argument("paths", nargs=-1, required=True)
 def main(
     debug: bool,
     pretty: bool,
     threads: int,
+    processes: int,
     rule_pack: str,
     ignore_list: str,
     skip_unprocessable: bool,
     cache_directory: str,
+    scan_cache: str,
+    timings: bool,
+    output: str,
     paths: List[str],
 ) -> None:
     """STACS - Static Token And Credential Scanner."""
@@ -105,6 +138,16 @@ def main(
             logger.error(f"Unable to load ignore list: {err}")
             sys.exit(-1)
 
+    # Where the cache directory was left at its default, prefer a tmpfs backed
+    # location - extracted members are written once and read once, so spooling them
+    # through a disk backed filesystem is pure overhead.
+    if cache_directory == stacs.scan.constants.CACHE_DIRECTORY:
+        preferred = stacs.scan.helper.preferred_cache_directory(cache_directory)
+
+        if preferred != cache_directory:
+            logger.info(f"Using tmpfs backed cache directory at {preferred}")
+            cache_directory = preferred
+
     # Append a timestamp to the cache directory to reduce the chance of collisions.
     cache_directory = os.path.join(cache_directory, str(int(time.time_ns() / 1000)))
     try:
@@ -136,11 +179,31 @@ def main(
     # Submit files for analysis.
     logger.info(f"Found {len(targets)} files for analysis")
 
+    # Where a persistent scan cache was requested, content scanned by a previous run
+    # with the same rule pack is resolved from cache rather than re-scanned.
+    results_cache = None
+    if scan_cache:
+        try:
+            results_cache = stacs.scan.scanner.cache.ScanCache(
+                scan_cache,
+                stacs.scan.scanner.cache.fingerprint(pack),
+            )
+            logger.info(f"Using persistent scan cache at {scan_cache}")
+        except stacs.scan.exceptions.STACSException as err:
+            logger.error(f"Unable to load scan cache: {err}")
+            sys.exit(-2)
+
     findings = []
     for scanner in stacs.scan.scanner.__all__:
         try:
             findings.extend(
-                getattr(stacs.scan.scanner, scanner).run(targets, pack, workers=threads)
+                getattr(stacs.scan.scanner, scanner).run(
+                    targets,
+                    pack,
+                    workers=threads,
+                    cache=results_cache,
+                    processes=processes,
+                )
             )
         except stacs.scan.exceptions.InvalidFormatException as err:
             logger.error(f"Unable to load a rule in scanner {scanner}: {err}")
@@ -153,6 +216,22 @@ def main(
     # Clean-up cache directory.
     shutil.rmtree(cache_directory, onerror=unlink_error)
 
+    # Print a per-format and per-phase summary of where time was spent, if requested.
+    # Counters are always collected, so this is just a read-out.
+    if timings:
+        logger.info("Run timing summary:")
+
+        for name, counters in stacs.scan.telemetry.snapshot().items():
+            calls = int(counters.pop("calls"))
+            seconds = counters.pop("seconds")
+            extra = ", ".join(
+                f"{key}={int(value)}" for key, value in sorted(counters.items())
+            )
+            logger.info(
+                f"    {name}: {calls} calls in {seconds:.3f}s"
+                + (f" ({extra})" if extra else "")
+            )
+
     # Determine the correct exit status based on whether there were unsuppressed
     # findings.
     exit_code = 0
@@ -167,14 +246,21 @@ def main(
         stacs.scan.output.pretty.render(findings, pack)
         sys.exit(exit_code)
 
-    # Default to SARIF output to STDOUT.
+    # Default to SARIF output, streamed to file if requested and STDOUT otherwise.
     logger.info("Generating SARIF from findings")
     try:
-        sarif = stacs.scan.output.sarif.render(path, findings, pack)
-    except stacs.scan.exceptions.STACSException as err:
+        if output:
+            with open(output, "wb") as fout:
+                stacs.scan.output.sarif.stream(path, findings, pack, fout)
+        else:
+            sarif = stacs.scan.output.sarif.render(path, findings, pack)
+    except (OSError, stacs.scan.exceptions.STACSException) as err:
         logger.error(f"Unable to generate SARIF: {err}")
         sys.exit(-3)
 
-    # TODO: Add file output as an option.
     logger.info(f"Found {len(findings)} findings")
-    print(sarif)
+
+    if output:
+        logger.info(f"SARIF written to {output}")
+    else:
+        print(sarif)
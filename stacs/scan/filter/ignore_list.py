@@ -4,8 +4,9 @@ SPDX-License-Identifier: BSD-3-Clause
 """
 
 import re
-from typing import List
+from typing import List, Tuple
 
+from stacs.native import filter as native_filter
 from stacs.scan.exceptions import IgnoreListException
 from stacs.scan.model import finding, ignore_list
 
@@ -98,45 +99,90 @@ def by_hash(finding: finding.Entry, ignore: ignore_list.Entry) -> bool:
     return False
 
 
+def compile(
+    ignore_list: ignore_list.Format,
+) -> Tuple["native_filter.IgnoreMatcher", List[int]]:
+    """Compiles an ignore list into the native matching engine.
+
+    Exact path and hash criteria are indexed into hash maps and pattern criteria
+    compiled to regular expressions exactly once, rather than being re-evaluated
+    per finding. Patterns the native engine cannot compile - such as those using
+    Python specific constructs like inline flags or named groups - are validated
+    against re and returned by rule index, for Python-side evaluation.
+    """
+    matcher = native_filter.IgnoreMatcher(
+        [
+            (
+                ignore.path or "",
+                ignore.pattern or "",
+                ignore.md5 or "",
+                ignore.module,
+                ignore.references,
+                ignore.offset if ignore.offset is not None else -1,
+            )
+            for ignore in ignore_list.ignore
+        ]
+    )
+
+    fallback = []
+
+    for index in matcher.unsupported():
+        ignore = ignore_list.ignore[index]
+
+        try:
+            re.compile(ignore.pattern)
+        except re.error as err:
+            raise IgnoreListException(
+                f"Error in ignore list entry '{ignore.reason}' with pattern "
+                f"'{ignore.pattern}': {err}"
+            )
+
+        fallback.append(index)
+
+    return matcher, fallback
+
+
 def process(
     findings: List[finding.Entry],
     ignore_list: ignore_list.Format,
 ) -> List[finding.Entry]:
     """Processes an ignore list and marks the relevant findings as ignored."""
-    filtered_findings = []
-
-    for entry in findings:
-        for ignore in ignore_list.ignore:
-            try:
-                if by_path(entry, ignore):
-                    ignore = finding.Ignore(
-                        ignored=True,
-                        reason=ignore.reason,
-                    )
-                    entry.ignore = ignore
-                    break
-
-                if by_pattern(entry, ignore):
-                    ignore = finding.Ignore(
-                        ignored=True,
-                        reason=ignore.reason,
-                    )
-                    entry.ignore = ignore
-                    break
-
-                if by_hash(entry, ignore):
-                    ignore = finding.Ignore(
-                        ignored=True,
-                        reason=ignore.reason,
-                    )
-                    entry.ignore = ignore
-                    break
-            except re.error as err:
-                raise IgnoreListException(
-                    f"Error in ignore list entry '{ignore.reason}': {err}"
-                )
-
-        # Add the finding to our results, whether updated or not.
-        filtered_findings.append(entry)
-
-    return filtered_findings
+    matcher, fallback = compile(ignore_list)
+
+    # All findings are matched against the compiled rules in a single native batch,
+    # with the GIL released - returning the index of the suppressing rule for each,
+    # or -1 where the finding is not suppressed.
+    decisions = matcher.match(
+        [
+            (
+                entry.path,
+                entry.md5 or "",
+                entry.source.module if entry.source else "",
+                entry.source.reference if entry.source else "",
+                entry.location.offset
+                if entry.location and entry.location.offset is not None
+                else -1,
+            )
+            for entry in findings
+        ]
+    )
+
+    for entry, decision in zip(findings, decisions):
+        # Pattern rules the native engine could not compile are evaluated here
+        # with re, preserving first-match semantics: the lowest matching rule
+        # index wins, whichever engine produced it.
+        for index in fallback:
+            if 0 <= decision <= index:
+                break
+
+            if by_pattern(entry, ignore_list.ignore[index]):
+                decision = index
+                break
+
+        if decision >= 0:
+            entry.ignore = finding.Ignore(
+                ignored=True,
+                reason=ignore_list.ignore[decision].reason,
+            )
+
+    return findings
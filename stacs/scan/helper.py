@@ -2,6 +2,7 @@
 
 SPDX-License-Identifier: BSD-3-Clause
 """
+import os
 from typing import List
 
 import colorama
@@ -9,6 +10,46 @@ from stacs.scan.constants import ARCHIVE_FILE_SEPARATOR
 from stacs.scan.exceptions import NoParentException
 
 
+def tmpfs_mounts() -> List[str]:
+    """Returns the mount points backed by tmpfs, or an empty list where unknown."""
+    mounts = []
+
+    try:
+        with open("/proc/mounts", "r") as fin:
+            for line in fin:
+                fields = line.split()
+
+                if len(fields) > 2 and fields[2] == "tmpfs":
+                    mounts.append(fields[1])
+    except OSError:
+        pass
+
+    return mounts
+
+
+def preferred_cache_directory(default: str) -> str:
+    """Returns the preferred cache directory for archive extraction.
+
+    Where the provided default is not backed by tmpfs but a memory backed filesystem
+    is available, extracted members are spooled to memory - rather than being written
+    through a disk backed, and often size limited, filesystem just to be read once by
+    the scanner. The default is returned unchanged where it is already on tmpfs, or
+    where no writable alternative exists.
+    """
+    mounts = tmpfs_mounts()
+    directory = os.path.abspath(default)
+
+    for mount in mounts:
+        if directory == mount or directory.startswith(mount.rstrip("/") + "/"):
+            return default
+
+    for candidate in ["/dev/shm"]:
+        if candidate in mounts and os.access(candidate, os.W_OK):
+            return candidate
+
+    return default
+
+
 def generate_virtual_path(
     finding: "Finding",  # noqa: F821
     artifacts: "List[Artifact]",  # noqa: F821
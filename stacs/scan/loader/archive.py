@@ -4,6 +4,8 @@ SPDX-License-Identifier: BSD-3-Clause
 """
 
 import bz2
+import contextlib
+import functools
 import gzip
 import hashlib
 import logging
@@ -12,9 +14,18 @@ import os
 import shutil
 import tarfile
 import zipfile
-
-from stacs.native import archive
-from stacs.scan.constants import CHUNK_SIZE
+from typing import List, Optional
+
+from stacs.native import archive, meta
+from stacs.scan.constants import (
+    ARCHIVE_MAXIMUM_COMPRESSION_RATIO,
+    ARCHIVE_MAXIMUM_MEMBER_SIZE,
+    ARCHIVE_MAXIMUM_TOTAL_SIZE,
+    ARCHIVE_SKIP_MEMBER_LARGER_THAN,
+    ARCHIVE_SKIP_MEMBER_PATTERNS,
+    CHUNK_SIZE,
+)
+from stacs.scan import telemetry
 from stacs.scan.exceptions import FileAccessException, InvalidFileException
 from stacs.scan.loader.format import xar
 
@@ -24,7 +35,58 @@ def path_hash(filepath: str) -> str:
     return hashlib.md5(bytes(filepath, "utf-8")).hexdigest()
 
 
-def zip_handler(filepath: str, directory: str) -> None:
+@contextlib.contextmanager
+def spooled_output(directory: str, filename: str):
+    """Yields a writable binary file which only appears in the directory on success.
+
+    Where supported, the file is created unlinked with O_TMPFILE and linked into
+    place once fully written - so a decompression which fails part way through, or a
+    crash mid-write, leaves nothing behind in the cache. A plain named file is used
+    where O_TMPFILE is unavailable, such as on non-Linux hosts or filesystems
+    without support.
+    """
+    destination = os.path.join(directory, filename)
+    tmpfile = getattr(os, "O_TMPFILE", None)
+
+    if tmpfile is not None:
+        try:
+            descriptor = os.open(directory, tmpfile | os.O_WRONLY, mode=0o600)
+        except OSError:
+            descriptor = None
+    else:
+        descriptor = None
+
+    # Confirm the unlinked inode can actually be linked back into the filesystem
+    # before any data is written to it - containers commonly restrict the /proc
+    # magic links this relies on.
+    if descriptor is not None:
+        probe = destination + ".spool"
+
+        try:
+            os.link(f"/proc/self/fd/{descriptor}", probe, follow_symlinks=True)
+            os.unlink(probe)
+        except OSError:
+            os.close(descriptor)
+            descriptor = None
+
+    if descriptor is None:
+        try:
+            with open(destination, "wb") as fout:
+                yield fout
+        except BaseException:
+            # Discard partial output on failure, matching the O_TMPFILE path.
+            with contextlib.suppress(OSError):
+                os.unlink(destination)
+            raise
+        return
+
+    with os.fdopen(descriptor, "wb") as fout:
+        yield fout
+        fout.flush()
+        os.link(f"/proc/self/fd/{descriptor}", destination, follow_symlinks=True)
+
+
+def zip_handler(filepath: str, directory: str) -> List[str]:
     """Attempts to extract the provided zip archive."""
     log = logging.getLogger(__name__)
 
@@ -61,8 +123,10 @@ def zip_handler(filepath: str, directory: str) -> None:
             f"Unable to extract archive {filepath} to {directory}: {err}"
         )
 
+    return []
+
 
-def tar_handler(filepath: str, directory: str) -> None:
+def tar_handler(filepath: str, directory: str) -> List[str]:
     """Attempts to extract the provided tarball."""
     try:
         os.mkdir(directory, mode=0o700)
@@ -80,8 +144,55 @@ def tar_handler(filepath: str, directory: str) -> None:
             f"Unable to extract archive {filepath} to {directory}: {err}"
         )
 
+    return []
+
+
+def tarball_handler(
+    filepath: str, directory: str, mime: str = None
+) -> Optional[List[str]]:
+    """Attempts a single-pass streaming extraction of a compressed tarball.
+
+    libarchive chains decompression filters with format readers, so a .tar.gz can be
+    extracted in one streaming pass rather than being decompressed into the cache and
+    re-processed as a tar. Returns None where the compressed payload is not itself a
+    supported archive, in which case the caller should fall back to single-file
+    decompression - and otherwise the directories produced by recursion into nested
+    archives.
+    """
+    log = logging.getLogger(__name__)
+
+    try:
+        with archive.ArchiveReader(filepath, format=mime or "") as reader:
+            reader.extract_all(
+                directory,
+                NESTED_MAGIC_TABLE,
+                max_member_size=ARCHIVE_MAXIMUM_MEMBER_SIZE,
+                max_total_size=ARCHIVE_MAXIMUM_TOTAL_SIZE,
+                max_ratio=ARCHIVE_MAXIMUM_COMPRESSION_RATIO,
+                skip_larger_than=ARCHIVE_SKIP_MEMBER_LARGER_THAN,
+                skip_patterns=ARCHIVE_SKIP_MEMBER_PATTERNS,
+            )
+
+        # The reader counts bytes and members natively as it extracts, so the per
+        # format aggregate only costs one record per archive. Wall time is recorded
+        # by the caller, so only the counters are merged here.
+        telemetry.record(mime or "application/octet-stream", calls=0, **reader.stats)
+        return list(reader.unpacked)
+    except archive.ArchiveBombError as err:
+        # Likely a decompression bomb. Anything already extracted is kept and will be
+        # scanned, but extraction stops here - falling back to Python decompression
+        # would just hit the same payload without a budget.
+        log.warn(f"Skipping remainder of archive at {filepath}: {err}")
+        return list(reader.unpacked)
+    except archive.ArchiveError:
+        # The payload isn't an archive - such as a plain gzipped file. Remove any
+        # partially extracted members before falling back.
+        shutil.rmtree(directory, ignore_errors=True)
+        os.mkdir(directory, mode=0o700)
+        return None
+
 
-def gzip_handler(filepath: str, directory: str) -> None:
+def gzip_handler(filepath: str, directory: str) -> List[str]:
     """Attempts to extract the provided gzip archive."""
     output = ".".join(os.path.basename(filepath).split(".")[:-1])
 
@@ -98,19 +209,25 @@ def gzip_handler(filepath: str, directory: str) -> None:
             f"Unable to create unpack directory at {directory}: {err}"
         )
 
-    # TODO: This can likely be optimized for tgz files, as currently the file will be
-    #       first processed and gunzipped, and then reprocessed to be extracted.
+    # Compressed tarballs are extracted natively in a single streaming pass, with only
+    # genuinely single-file payloads falling through to be gunzipped here.
+    unpacked = tarball_handler(filepath, directory, mime="application/gzip")
+    if unpacked is not None:
+        return unpacked
+
     try:
         with gzip.open(filepath, "rb") as fin:
-            with open(os.path.join(directory, output), "wb") as fout:
+            with spooled_output(directory, output) as fout:
                 shutil.copyfileobj(fin, fout, CHUNK_SIZE)
     except gzip.BadGzipFile as err:
         raise InvalidFileException(
             f"Unable to extract archive {filepath} to {output}: {err}"
         )
 
+    return []
+
 
-def bzip2_handler(filepath: str, directory: str) -> None:
+def bzip2_handler(filepath: str, directory: str) -> List[str]:
     """Attempts to extract the provided bzip2 archive."""
     output = ".".join(os.path.basename(filepath).split(".")[:-1])
 
@@ -123,19 +240,25 @@ def bzip2_handler(filepath: str, directory: str) -> None:
             f"Unable to create unpack directory at {directory}: {err}"
         )
 
-    # TODO: This can likely be optimized for tbz files, as currently the file will be
-    #       first processed and gunzipped, and then reprocessed to be extracted.
+    # Compressed tarballs are extracted natively in a single streaming pass, with only
+    # genuinely single-file payloads falling through to be decompressed here.
+    unpacked = tarball_handler(filepath, directory, mime="application/x-bzip2")
+    if unpacked is not None:
+        return unpacked
+
     try:
         with bz2.open(filepath, "rb") as fin:
-            with open(os.path.join(directory, output), "wb") as fout:
+            with spooled_output(directory, output) as fout:
                 shutil.copyfileobj(fin, fout, CHUNK_SIZE)
     except (OSError, ValueError) as err:
         raise InvalidFileException(
             f"Unable to extract archive {filepath} to {output}: {err}"
         )
 
+    return []
+
 
-def lzma_handler(filepath: str, directory: str) -> None:
+def lzma_handler(filepath: str, directory: str) -> List[str]:
     """Attempts to extract the provided xz / lzma archive."""
     output = ".".join(os.path.basename(filepath).split(".")[:-1])
 
@@ -152,17 +275,25 @@ def lzma_handler(filepath: str, directory: str) -> None:
             f"Unable to create unpack directory at {directory}: {err}"
         )
 
+    # Compressed tarballs are extracted natively in a single streaming pass, with only
+    # genuinely single-file payloads falling through to be decompressed here.
+    unpacked = tarball_handler(filepath, directory, mime="application/x-xz")
+    if unpacked is not None:
+        return unpacked
+
     try:
         with lzma.open(filepath, "rb") as fin:
-            with open(os.path.join(directory, output), "wb") as fout:
+            with spooled_output(directory, output) as fout:
                 shutil.copyfileobj(fin, fout, CHUNK_SIZE)
     except lzma.LZMAError as err:
         raise InvalidFileException(
             f"Unable to extract archive {filepath} to {output}: {err}"
         )
 
+    return []
+
 
-def xar_handler(filepath: str, directory: str) -> None:
+def xar_handler(filepath: str, directory: str) -> List[str]:
     """Attempts to extract the provided XAR archive."""
     try:
         os.mkdir(directory, mode=0o700)
@@ -171,6 +302,13 @@ def xar_handler(filepath: str, directory: str) -> None:
             f"Unable to create unpack directory at {directory}: {err}"
         )
 
+    # Prefer native extraction: libarchive reads XAR directly (when built with XML
+    # support), with heap decompression performed in C and the GIL released. The
+    # pure-Python parser is retained as a fallback for builds without XAR support.
+    unpacked = tarball_handler(filepath, directory, mime="application/x-xar")
+    if unpacked is not None:
+        return unpacked
+
     # Attempt to unpack the archive.
     try:
         archive = xar.XAR(filepath)
@@ -184,9 +322,15 @@ def xar_handler(filepath: str, directory: str) -> None:
             f"Unable to extract archive {filepath} to {directory}: {err}"
         )
 
+    return []
 
-def libarchive_handler(filepath: str, directory: str) -> None:
+
+def libarchive_handler(
+    filepath: str, directory: str, mime: str = None
+) -> List[str]:
     """Attempts to extract the provided archive with libarchive."""
+    log = logging.getLogger(__name__)
+
     try:
         os.mkdir(directory, mode=0o700)
     except OSError as err:
@@ -194,40 +338,34 @@ def libarchive_handler(filepath: str, directory: str) -> None:
             f"Unable to create unpack directory at {directory}: {err}"
         )
 
-    # Attempt to unpack the archive to the new unpack directory.
+    # Attempt to unpack the archive to the new unpack directory. The full extraction
+    # loop - including member path sanitisation and recursion into nested archives -
+    # is performed natively, so only a single call into the extension is required per
+    # archive. The MIME type detected above is passed down as a format hint, so that
+    # only the matching libarchive reader bids on the open. Decompression budgets are
+    # enforced inside of the native read loop, bounding the worst-case cost of a
+    # hostile archive.
     try:
-        with archive.ArchiveReader(filepath) as reader:
-            for entry in reader:
-                member = entry.filename
-                member = member.lstrip("../")
-                member = member.lstrip("./")
-
-                if entry.filename == ".":
-                    continue
-
-                destination = os.path.join(directory, member)
-                parent = os.path.dirname(destination)
-
-                # Handle odd cases where a file was created where a directory needs to
-                # be.
-                if os.path.exists(parent) and os.path.isfile(parent):
-                    os.unlink(parent)
-
-                if os.path.isdir(destination):
-                    continue
-
-                # Create parent directories, as required.
-                if not os.path.isdir(parent):
-                    os.makedirs(parent)
-
-                # If the entry is a directory, create it and move on.
-                if entry.isdir:
-                    os.makedirs(destination, exist_ok=True)
-                    continue
-
-                with open(destination, "wb") as fout:
-                    while reader.read() > 0:
-                        fout.write(reader.chunk)
+        with archive.ArchiveReader(filepath, format=mime or "") as reader:
+            reader.extract_all(
+                directory,
+                NESTED_MAGIC_TABLE,
+                max_member_size=ARCHIVE_MAXIMUM_MEMBER_SIZE,
+                max_total_size=ARCHIVE_MAXIMUM_TOTAL_SIZE,
+                max_ratio=ARCHIVE_MAXIMUM_COMPRESSION_RATIO,
+                skip_larger_than=ARCHIVE_SKIP_MEMBER_LARGER_THAN,
+                skip_patterns=ARCHIVE_SKIP_MEMBER_PATTERNS,
+            )
+
+        # Merge the reader's native byte and member counters into the per format
+        # aggregate. Wall time is recorded by the caller.
+        telemetry.record(mime or "application/octet-stream", calls=0, **reader.stats)
+        return list(reader.unpacked)
+    except archive.ArchiveBombError as err:
+        # Likely a decompression bomb. Anything already extracted is kept and will be
+        # scanned, but the remainder of the archive is skipped.
+        log.warn(f"Skipping remainder of archive at {filepath}: {err}")
+        return list(reader.unpacked)
     except archive.ArchiveError as err:
         raise InvalidFileException(
             f"Unable to extract archive {filepath} to {directory}: {err}"
@@ -241,15 +379,7 @@ def get_mimetype(chunk: bytes) -> str:
     However, currently this is not an issue, but may need to be revisited later as more
     archive types are supported.
     """
-    for name, options in MIME_TYPE_HANDLERS.items():
-        offset = options["offset"]
-        magic = options["magic"]
-
-        for candidate in magic:
-            if chunk[offset : (offset + len(candidate))] == candidate:  # noqa: E203
-                return name
-
-    return None
+    return MAGIC_MATCHER.match(chunk) or None
 
 
 # Define all supported archives and their handlers. As we currently only support a small
@@ -300,21 +430,25 @@ MIME_TYPE_HANDLERS = {
         "magic": [
             bytearray([0xED, 0xAB, 0xEE, 0xDB]),
         ],
-        "handler": libarchive_handler,
+        "handler": functools.partial(libarchive_handler, mime="application/x-rpm"),
     },
     "application/x-iso9660-image": {
         "offset": 0x8001,
         "magic": [
             bytearray([0x43, 0x44, 0x30, 0x30, 0x31]),
         ],
-        "handler": libarchive_handler,
+        "handler": functools.partial(
+            libarchive_handler, mime="application/x-iso9660-image"
+        ),
     },
     "application/x-7z-compressed": {
         "offset": 0,
         "magic": [
             bytearray([0x37, 0x7A, 0xBC, 0xAF, 0x27, 0x1C]),
         ],
-        "handler": libarchive_handler,
+        "handler": functools.partial(
+            libarchive_handler, mime="application/x-7z-compressed"
+        ),
     },
     "application/x-cpio": {
         "offset": 0,
@@ -325,7 +459,7 @@ MIME_TYPE_HANDLERS = {
             bytearray([0x30, 0x37, 0x30, 0x37, 0x30, 0x32]),  # "070702"
             bytearray([0x30, 0x37, 0x30, 0x37, 0x30, 0x37]),  # "070707"
         ],
-        "handler": libarchive_handler,
+        "handler": functools.partial(libarchive_handler, mime="application/x-cpio"),
     },
     "application/x-xar": {
         "offset": 0,
@@ -339,27 +473,51 @@ MIME_TYPE_HANDLERS = {
         "magic": [
             bytearray([0x4D, 0x53, 0x43, 0x46]),
         ],
-        "handler": libarchive_handler,
+        "handler": functools.partial(
+            libarchive_handler, mime="application/vnd.ms-cab-compressed"
+        ),
     },
     "application/x-archive": {
         "offset": 0,
         "magic": [
             bytearray([0x21, 0x3C, 0x61, 0x72, 0x63, 0x68, 0x3E]),
         ],
-        "handler": libarchive_handler,
+        "handler": functools.partial(libarchive_handler, mime="application/x-archive"),
     },
     "application/vnd.rar": {
         "offset": 0,
         "magic": [
             bytearray([0x52, 0x61, 0x72, 0x21, 0x1A, 0x07]),
         ],
-        "handler": libarchive_handler,
+        "handler": functools.partial(libarchive_handler, mime="application/vnd.rar"),
     },
     "application/zstd": {
         "offset": 0,
         "magic": [
             bytearray([0x28, 0xB5, 0x2F, 0xFD]),
         ],
-        "handler": libarchive_handler,
+        "handler": functools.partial(libarchive_handler, mime="application/zstd"),
     },
 }
+
+# A flattened representation of the magic table, in a form suitable for passing to
+# the native metadata engine.
+MAGIC_TABLE = [
+    (name, options["offset"], [bytes(magic) for magic in options["magic"]])
+    for name, options in MIME_TYPE_HANDLERS.items()
+]
+
+# Magic entries used by the native extractor to detect archives nested inside of
+# other archives. All supported formats are included: members which match but which
+# libarchive cannot actually read - such as single-file gzip - are simply left in
+# place for the handlers above to process on the next pass.
+NESTED_MAGIC_TABLE = [
+    (options["offset"], bytes(magic))
+    for options in MIME_TYPE_HANDLERS.values()
+    for magic in options["magic"]
+]
+
+# Compile the magic table into the native matcher once at import time. Detection cost
+# then stays constant as formats are added, while the table above remains the single
+# place new formats are defined.
+MAGIC_MATCHER = meta.MagicMatcher(MAGIC_TABLE)
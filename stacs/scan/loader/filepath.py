@@ -3,15 +3,21 @@
 SPDX-License-Identifier: BSD-3-Clause
 """
 
-import hashlib
 import logging
 import os
 import re
 import shutil
+import time
 from concurrent.futures import ThreadPoolExecutor, as_completed
-from typing import List
+from typing import Dict, Iterator, List, Set
 
-from stacs.scan.constants import ARCHIVE_FILE_SEPARATOR, CHUNK_SIZE
+from stacs.native import meta
+from stacs.scan import telemetry
+from stacs.scan.constants import (
+    ARCHIVE_FILE_SEPARATOR,
+    METADATA_BATCH_SIZE,
+    UNPACKED_ARCHIVE_SUFFIX,
+)
 from stacs.scan.exceptions import FileAccessException, InvalidFileException
 from stacs.scan.loader import archive
 from stacs.scan.model.manifest import Entry
@@ -19,59 +25,102 @@ from stacs.scan.model.manifest import Entry
 logger = logging.getLogger(__name__)
 
 
+def batched(items: List[str], size: int = METADATA_BATCH_SIZE) -> Iterator[List[str]]:
+    """Yields fixed size batches from a list of items."""
+    for index in range(0, len(items), size):
+        yield items[index : index + size]  # noqa: E203
+
+
 def metadata(filepath: str, overlay: str = None) -> Entry:
     """Generates a hash and determines the mimetype of the input file."""
-    md5 = hashlib.md5()
-    mime = None
+    return metadata_many(
+        [filepath],
+        overlays={filepath: overlay},
+        skip_on_eacces=False,
+    )[0]
+
 
-    # Read the file in chunks.
-    try:
-        with open(filepath, "rb") as fin:
-            while chunk := fin.read(CHUNK_SIZE):
-                md5.update(chunk)
+def metadata_many(
+    filepaths: List[str],
+    overlays: Dict[str, str] = None,
+    skip_on_eacces: bool = True,
+) -> List[Entry]:
+    """Generates hashes and mimetypes for a batch of files in one native call."""
+    if overlays is None:
+        overlays = {}
 
-                # Only attempt to determine the filetype on the first chunk.
-                if not mime and fin.tell() <= CHUNK_SIZE:
-                    mime = archive.get_mimetype(chunk)
-    except OSError as err:
-        raise FileAccessException(f"Unable to open file at {filepath}: {err}")
+    entries = []
 
-    return Entry(
-        path=filepath,
-        md5=md5.hexdigest(),
-        mime=mime,
-        overlay=overlay,
-    )
+    # Hashing and magic detection are both performed natively, with the GIL released,
+    # so a single call into the extension covers the entire batch.
+    for summary in meta.summarize(filepaths, archive.MAGIC_MATCHER):
+        if summary.error:
+            if skip_on_eacces:
+                logger.warning(
+                    f"Unable to open file at {summary.path}: {summary.error}"
+                )
+                continue
+
+            raise FileAccessException(
+                f"Unable to open file at {summary.path}: {summary.error}"
+            )
+
+        entries.append(
+            Entry(
+                path=summary.path,
+                md5=summary.md5,
+                mime=summary.mime if summary.mime else None,
+                binary=summary.binary,
+                overlay=overlays.get(summary.path),
+            )
+        )
+
+    return entries
 
 
 def walker(path: str, skip_on_eacces: bool) -> List[str]:
     """Recursively walk a file path, returning a list of all files."""
-    entries = []
+    # The walk itself is performed natively on a small thread pool, with the GIL
+    # released - each directory is read exactly once, and symlinks are never
+    # followed.
+    result = meta.walk(path)
 
-    # TODO: Would moving walker to a generator yield a performance increase, or lead to
-    #       higher disk contention due to the hasher running at the same time?
-    try:
-        with os.scandir(path) as scan:
-            for handle in scan:
-                try:
-                    # Recurse on directories, but not symlinks.
-                    if handle.is_dir() and not handle.is_symlink():
-                        entries.extend(walker(handle.path, skip_on_eacces))
-
-                    # Track files, but not symlinks.
-                    if handle.is_file() and not handle.is_symlink():
-                        entries.append(handle.path)
-                except PermissionError:
-                    if not skip_on_eacces:
-                        raise
-                except OSError:
-                    # This is usually due to too many levels of symlinks. However, other
-                    # cases are likely with a large enough input.
-                    continue
-    except NotADirectoryError:
-        entries.append(path)
+    # A root which cannot be stat'd or opened at all is an error rather than a
+    # skippable condition, matching the previous os.scandir behaviour.
+    if result.failure:
+        raise FileAccessException(f"Unable to walk path at {result.failure}")
+
+    for denied in result.denied:
+        if not skip_on_eacces:
+            raise PermissionError(f"Unable to read directory at {denied}")
+
+        logger.warning(f"Unable to read directory at {denied}, skipping")
+
+    return result.files
+
+
+def overlay_suffix(file: str, destination: str, unpacked: Set[str]) -> str:
+    """Builds the overlay path suffix for a file extracted under the cache.
+
+    Directories created by native recursive unpacking are rewritten back into
+    virtual path separators, so that overlays follow the usual nested archive
+    convention. Only directories the extractor reported producing are rewritten,
+    so archive members which legitimately use the unpacked naming convention are
+    left untouched.
+    """
+    suffix = ""
+    current = destination.rstrip("/")
 
-    return list(set(entries))
+    for component in re.sub(rf"^{destination}/?", "", file).split("/"):
+        current = f"{current}/{component}"
+
+        if current in unpacked:
+            suffix += component[: -len(UNPACKED_ARCHIVE_SUFFIX)]
+            suffix += ARCHIVE_FILE_SEPARATOR
+        else:
+            suffix += f"{component}/"
+
+    return suffix.rstrip("/")
 
 
 def qualify(path: str) -> str:
@@ -93,10 +142,18 @@ def finder(
     entries = []
     futures = dict()
 
+    # Every directory the native extractor reports producing while recursively
+    # unpacking nested archives, by full path. Only these are treated as unpacked
+    # output - an archive member which merely shares the naming convention is not.
+    unpacked = set()
+
     # Run the metadata enumerator in a thread pool as we're likely to be I/O bound.
+    # Files are submitted in batches to amortise the cost of crossing into the native
+    # metadata engine.
     with ThreadPoolExecutor(max_workers=workers) as pool:
         futures = {
-            pool.submit(metadata, file): file for file in walker(path, skip_on_eacces)
+            pool.submit(metadata_many, batch, skip_on_eacces=skip_on_eacces): batch
+            for batch in batched(walker(path, skip_on_eacces))
         }
 
         # A loop and counter is used here to ensure that additional work which may be
@@ -107,60 +164,96 @@ def finder(
                 complete += 1
 
                 try:
-                    result = future.result()
+                    results = future.result()
                 except FileAccessException:
                     if not skip_on_eacces:
                         raise
 
-                # Track the result and then remove the future from the initial futures
+                    del futures[future]
+                    continue
+
+                # Track the results and then remove the future from the initial futures
                 # list so that these results aren't returned again next iteration.
-                entries.append(result)
+                entries.extend(results)
                 del futures[future]
 
-                # Check it the file was found to be an archive, and if so, unpack it.
-                handler = archive.MIME_TYPE_HANDLERS.get(result.mime, {}).get("handler")
-                if not handler:
-                    continue
+                for result in results:
+                    # Check if the file was found to be an archive, and if so, unpack
+                    # it.
+                    handler = archive.MIME_TYPE_HANDLERS.get(result.mime, {}).get(
+                        "handler"
+                    )
+                    if not handler:
+                        continue
 
-                # Remove any existing previously unpacked files, then unpack the archive
-                # and submit extracted files back into the queue. This is to allow for
-                # easy recursive unpacking of nested archives.
-                destination = os.path.join(cache, archive.path_hash(result.path))
-                shutil.rmtree(destination, ignore_errors=True)
+                    # Archives which the native extractor has already recursively
+                    # unpacked - into a sibling directory inside the cache - do not
+                    # need to be processed again. A pre-existing directory which
+                    # happens to carry the suffix does not suppress extraction.
+                    if result.path + UNPACKED_ARCHIVE_SUFFIX in unpacked:
+                        continue
 
-                try:
-                    handler(result.path, destination)
-                except InvalidFileException as err:
-                    # Only skip with a warning if explicitly configured to do so.
-                    if skip_on_corrupt:
-                        logger.warning(
-                            f"Skipping file at {result.path} due to error when "
-                            f"processing: {err}"
-                        )
-                    else:
-                        raise
+                    # Remove any existing previously unpacked files, then unpack the
+                    # archive and submit extracted files back into the queue. This is
+                    # to allow for easy recursive unpacking of nested archives.
+                    destination = os.path.join(cache, archive.path_hash(result.path))
+                    shutil.rmtree(destination, ignore_errors=True)
+
+                    started = time.monotonic()
+                    produced = []
+
+                    try:
+                        produced = handler(result.path, destination) or []
+                    except InvalidFileException as err:
+                        # Only skip with a warning if explicitly configured to do so.
+                        if skip_on_corrupt:
+                            logger.warning(
+                                f"Skipping file at {result.path} due to error when "
+                                f"processing: {err}"
+                            )
+                        else:
+                            raise
+                    finally:
+                        # Wall time is aggregated per format, so a run summary can
+                        # report where extraction time was actually spent.
+                        telemetry.record(result.mime, time.monotonic() - started)
 
-                for file in walker(destination, skip_on_eacces):
-                    # The overlay path is a 'virtual' path that is constructed based on
-                    # the archive the file appears inside of, and the path of the file
-                    # inside of the archive. However, as archives may be nested, we need
-                    # to check whether we already have an overlay and, if set, use that
-                    # value instead.
+                    unpacked.update(produced)
+
+                    # The overlay path is a 'virtual' path that is constructed based
+                    # on the archive the file appears inside of, and the path of the
+                    # file inside of the archive. However, as archives may be nested,
+                    # we need to check whether we already have an overlay and, if set,
+                    # use that value instead.
                     if result.overlay:
                         parent = result.overlay
                     else:
                         parent = result.path
 
-                    logger.debug(f"Processing {file}, extracted from archive {parent}")
-                    overlay = (
-                        f"{parent}"
-                        f"{ARCHIVE_FILE_SEPARATOR}"
-                        f"{re.sub(rf'^{destination}/?', '', file)}"
-                    )
+                    overlays = {}
+                    for file in walker(destination, skip_on_eacces):
+                        logger.debug(
+                            f"Processing {file}, extracted from archive {parent}"
+                        )
+
+                        # Rewrite the directories created by native recursive
+                        # unpacking back into virtual path separators, so that
+                        # overlays follow the usual nested archive convention.
+                        relative = overlay_suffix(file, destination, unpacked)
+
+                        overlays[file] = (
+                            f"{parent}{ARCHIVE_FILE_SEPARATOR}{relative}"
+                        )
 
                     # Submit back to the pool for processing.
-                    submission = pool.submit(metadata, file, overlay=overlay)
-                    futures[submission] = file
+                    for batch in batched(list(overlays)):
+                        submission = pool.submit(
+                            metadata_many,
+                            batch,
+                            overlays=overlays,
+                            skip_on_eacces=skip_on_eacces,
+                        )
+                        futures[submission] = batch
 
             if complete == 0:
                 break
@@ -29,6 +29,10 @@ class Entry(BaseModel, extra=Extra.forbid):
         None,
         title="The mimetype of the file.",
     )
+    binary: bool = Field(
+        None,
+        title="Whether the file contents appear to be binary, rather than text.",
+    )
 
 
 class Format(BaseModel, extra=Extra.forbid):
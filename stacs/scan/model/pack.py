@@ -35,6 +35,14 @@ class Format(BaseModel, extra=Extra.forbid):
         [],
         title="A list of pack entries.",
     )
+    atoms: List[str] = Field(
+        [],
+        title=(
+            "An optional list of literal substrings which every rule in the pack "
+            "requires at least one of. Files containing none of them are filtered "
+            "out before rule evaluation."
+        ),
+    )
 
 
 def from_file(filename: str) -> Format:
@@ -65,6 +73,7 @@ def from_file(filename: str) -> Format:
     for file in parent_pack.include:
         child_pack = from_file(file)
         parent_pack.pack.extend(child_pack.pack)
+        parent_pack.atoms.extend(child_pack.atoms)
 
     # Finally strip the included packs from the entry, as these have been resolved,
     # returning the loaded pack to the caller.
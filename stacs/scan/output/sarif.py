@@ -4,10 +4,11 @@ SPDX-License-Identifier: BSD-3-Clause
 """
 
 import base64
-import json
+import io
 import re
-from typing import Any, Dict, List, Optional, Tuple
+from typing import Any, BinaryIO, Dict, Iterable, List, Optional, Tuple
 
+from stacs.native import output
 from stacs.scan import __about__, model
 from stacs.scan.constants import ARCHIVE_FILE_SEPARATOR
 
@@ -94,125 +95,154 @@ def add_artifact(
     return (parent, artifacts)
 
 
-def render(
-    root: str, findings: List[model.finding.Entry], pack: model.pack.Format
-) -> str:
-    """Renders down a SARIF document for STACS findings."""
-    rules = []
-    results = []
-    artifacts = []
+def render_result(
+    root: str,
+    finding: model.finding.Entry,
+    rules: List[Dict[str, Any]],
+    artifacts: List[Dict[str, Any]],
+) -> Dict[str, Any]:
+    """Renders a result (SARIF v2.1.0 Section 3.27) for a single finding.
+
+    The provided rules and artifacts lists are updated in place as new rules and
+    artifact paths are encountered.
+    """
+    # Suppressions (SARIF v2.1.0 Section 3.27.23) are used to track findings where
+    # there is an "ignore" set - via ignore list.
+    suppressions = []
+
+    # Create an artifactContent (SARIF v2.1.0 Section 3.3) entry to track the sample
+    # of the finding.
+    context_content = {}
+    artifact_content = {}
+
+    if finding.sample.binary:
+        artifact_content["binary"] = finding.sample.finding
+        # Unencode and then re-encode the sample into a single B64 string to provide
+        # context.
+        context_content["binary"] = str(
+            base64.b64encode(
+                base64.b64decode(finding.sample.before)
+                + base64.b64decode(finding.sample.finding)
+                + base64.b64decode(finding.sample.after)
+            ),
+            "utf-8",
+        )
+    else:
+        artifact_content["text"] = finding.sample.finding
+        context_content["text"] = (
+            finding.sample.before + finding.sample.finding + finding.sample.after
+        )
 
-    # Generate a result (SARIF v2.1.0 Section 3.27) for each finding.
-    for finding in findings:
-        # Suppressions (SARIF v2.1.0 Section 3.27.23) are used to track findings where
-        # there is an "ignore" set - via ignore list.
-        suppressions = []
-
-        # Create an artifactContent (SARIF v2.1.0 Section 3.3) entry to track the sample
-        # of the finding.
-        context_content = {}
-        artifact_content = {}
-
-        if finding.sample.binary:
-            artifact_content["binary"] = finding.sample.finding
-            # Unencode and then re-encode the sample into a single B64 string to provide
-            # context.
-            context_content["binary"] = str(
-                base64.b64encode(
-                    base64.b64decode(finding.sample.before)
-                    + base64.b64decode(finding.sample.finding)
-                    + base64.b64decode(finding.sample.after)
-                ),
-                "utf-8",
-            )
-        else:
-            artifact_content["text"] = finding.sample.finding
-            context_content["text"] = (
-                finding.sample.before + finding.sample.finding + finding.sample.after
-            )
-
-        # Create a new contextRegion (SARIF v2.1.0 Section 3.29.5) to provide contextual
-        # information about the finding, but do not include the byte or line number
-        # offset.
-        context = {"snippet": context_content}
-
-        # Create a new region (SARIF v2.1.0 Section 3.30) to track the location of the
-        # finding and the sample.
-        region = {
-            "byteOffset": finding.location.offset,
-            "snippet": artifact_content,
-        }
+    # Create a new contextRegion (SARIF v2.1.0 Section 3.29.5) to provide contextual
+    # information about the finding, but do not include the byte or line number
+    # offset.
+    context = {"snippet": context_content}
 
-        # Line numbers are optional, as the input file may be binary.
-        if finding.location.line:
-            region["startLine"] = finding.location.line
-
-        # Add a new artifact for this finding, or retrieve the location of the existing.
-        index, artifacts = add_artifact(root, finding, artifacts)
-
-        # Strip the scan directory root from the path, as the we're using the reference
-        # from originalUriBaseIds (SARIF v2.1.0 Section 3.14.14) to allow "portability".
-        path = finding.path.split(ARCHIVE_FILE_SEPARATOR)[-1]
-        relative_path = re.sub(rf"^{root}", "", path).lstrip("/")
-
-        # Pin the artifact location back to a physical location (SARIF v2.1.0 Section
-        # 3.28.3).
-        physical_location = {
-            "physicalLocation": {
-                "region": region,
-                "contextRegion": context,
-                "artifactLocation": {
-                    "uri": relative_path,
-                    "index": index,
-                    "uriBaseId": SARIF_URI_BASE_ID,
-                },
+    # Create a new region (SARIF v2.1.0 Section 3.30) to track the location of the
+    # finding and the sample.
+    region = {
+        "byteOffset": finding.location.offset,
+        "snippet": artifact_content,
+    }
+
+    # Line numbers are optional, as the input file may be binary.
+    if finding.location.line:
+        region["startLine"] = finding.location.line
+
+    # Add a new artifact for this finding, or retrieve the location of the existing.
+    index, artifacts = add_artifact(root, finding, artifacts)
+
+    # Strip the scan directory root from the path, as the we're using the reference
+    # from originalUriBaseIds (SARIF v2.1.0 Section 3.14.14) to allow "portability".
+    path = finding.path.split(ARCHIVE_FILE_SEPARATOR)[-1]
+    relative_path = re.sub(rf"^{root}", "", path).lstrip("/")
+
+    # Pin the artifact location back to a physical location (SARIF v2.1.0 Section
+    # 3.28.3).
+    physical_location = {
+        "physicalLocation": {
+            "region": region,
+            "contextRegion": context,
+            "artifactLocation": {
+                "uri": relative_path,
+                "index": index,
+                "uriBaseId": SARIF_URI_BASE_ID,
+            },
+        },
+    }
+
+    # Generate a new Rule entry, if required (SARIF v2.1.0 Section 3.49).
+    rule = None
+
+    for candidate in rules:
+        if finding.source.reference == candidate.get("id"):
+            rule = candidate
+            break
+
+    if not rule:
+        # Add the description from the original rule pack entry into the Rule for
+        # easy tracking.
+        rule = {
+            "id": finding.source.reference,
+            "shortDescription": {
+                "text": finding.source.description,
             },
         }
+        rules.append(rule)
 
-        # Generate a new Rule entry, if required (SARIF v2.1.0 Section 3.49).
-        rule = None
-
-        for candidate in rules:
-            if finding.source.reference == candidate.get("id"):
-                rule = candidate
-                break
-
-        if not rule:
-            # Add the description from the original rule pack entry into the Rule for
-            # easy tracking.
-            rule = {
-                "id": finding.source.reference,
-                "shortDescription": {
-                    "text": finding.source.description,
-                },
-            }
-            rules.append(rule)
-
-        # Add a Suppression entry if this finding was marked as "Ignored", along with
-        # the reason (justification) from the original ignore list.
-        if finding.ignore is not None and finding.ignore.ignored:
-            suppressions.append(
-                {
-                    "kind": "external",
-                    "status": "accepted",
-                    "justification": finding.ignore.reason,
-                }
-            )
-
-        # Track the finding (Result).
-        results.append(
+    # Add a Suppression entry if this finding was marked as "Ignored", along with
+    # the reason (justification) from the original ignore list.
+    if finding.ignore is not None and finding.ignore.ignored:
+        suppressions.append(
             {
-                "message": rule.get("shortDescription"),
-                "level": confidence_to_level(finding.confidence),
-                "ruleId": finding.source.reference,
-                "locations": [
-                    physical_location,
-                ],
-                "suppressions": suppressions,
+                "kind": "external",
+                "status": "accepted",
+                "justification": finding.ignore.reason,
             }
         )
 
-    # Add a toolComponent (SARIF v2.1.0 Section 3.19), and bolt it all together.
+    # The finding (Result).
+    return {
+        "message": rule.get("shortDescription"),
+        "level": confidence_to_level(finding.confidence),
+        "ruleId": finding.source.reference,
+        "locations": [
+            physical_location,
+        ],
+        "suppressions": suppressions,
+    }
+
+
+def stream(
+    root: str,
+    findings: Iterable[model.finding.Entry],
+    pack: model.pack.Format,
+    fout: BinaryIO,
+) -> None:
+    """Streams a SARIF document for STACS findings to the provided binary stream.
+
+    Each result is encoded and written as it is consumed from the findings iterable,
+    so memory during report generation is bounded by the rule and artifact tables -
+    which grow with unique rules and paths - rather than the number of findings. The
+    JSON encoding itself is performed natively, directly to UTF-8.
+    """
+    rules = []
+    artifacts = []
+
+    fout.write(b'{"version":')
+    fout.write(output.encode(SARIF_VERSION))
+    fout.write(b',"$schema":')
+    fout.write(output.encode(SARIF_SCHEMA_URI))
+    fout.write(b',"runs":[{"results":[')
+
+    for index, finding in enumerate(findings):
+        if index:
+            fout.write(b",")
+
+        fout.write(output.encode(render_result(root, finding, rules, artifacts)))
+
+    # Add a toolComponent (SARIF v2.1.0 Section 3.19), and bolt it all together. The
+    # rules table must trail the results, as it is built as they are rendered.
     tool = {
         "driver": {
             "name": __about__.__title__.upper(),
@@ -222,23 +252,29 @@ def render(
             "informationUri": __about__.__uri__,
         },
     }
-    run = {
-        "tool": tool,
-        "results": results,
-        "artifacts": artifacts,
-        "originalUriBaseIds": {
-            SARIF_URI_BASE_ID: {
-                "uri": f"file://{root.rstrip('/')}/",
-            },
-        },
-    }
-    sarif = {
-        "version": SARIF_VERSION,
-        "$schema": SARIF_SCHEMA_URI,
-        "runs": [
-            run,
-        ],
-    }
 
-    # Return a stringified JSON representation of the SARIF document.
-    return json.dumps(sarif)
+    fout.write(b'],"tool":')
+    fout.write(output.encode(tool))
+    fout.write(b',"artifacts":')
+    fout.write(output.encode(artifacts))
+    fout.write(b',"originalUriBaseIds":')
+    fout.write(
+        output.encode(
+            {
+                SARIF_URI_BASE_ID: {
+                    "uri": f"file://{root.rstrip('/')}/",
+                },
+            }
+        )
+    )
+    fout.write(b"}]}")
+
+
+def render(
+    root: str, findings: List[model.finding.Entry], pack: model.pack.Format
+) -> str:
+    """Renders down a SARIF document for STACS findings."""
+    buffer = io.BytesIO()
+    stream(root, findings, pack, buffer)
+
+    return str(buffer.getvalue(), "utf-8")
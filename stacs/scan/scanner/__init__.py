@@ -3,9 +3,10 @@
 SPDX-License-Identifier: BSD-3-Clause
 """
 
-from stacs.scan.scanner import rules
+from stacs.scan.scanner import cache, rules  # noqa: F401
 
-# Export all enabled scanners.
+# Export all enabled scanners. The cache module is deliberately not listed, as it is
+# not a scanner.
 __all__ = [
     "rules",
 ]
@@ -0,0 +1,150 @@
+"""Implements a persistent incremental-scan cache for STACS scanners.
+
+SPDX-License-Identifier: BSD-3-Clause
+"""
+
+import fcntl
+import hashlib
+import json
+import mmap
+import os
+import struct
+from typing import List, Optional
+
+from stacs.scan.exceptions import FileAccessException
+from stacs.scan.model import finding, pack
+
+# Each index record is a raw MD5 digest, followed by the offset and length of the
+# serialized findings inside of the data file.
+INDEX_RECORD = struct.Struct("<16sQQ")
+
+
+def fingerprint(ruleset: pack.Format) -> str:
+    """Generates a fingerprint for the provided rule pack.
+
+    The fingerprint covers the contents of every rule file in the pack, so any change
+    to a rule yields a new fingerprint - and cached results from older rules are never
+    returned.
+    """
+    digest = hashlib.md5()
+
+    for rule in sorted(ruleset.pack, key=lambda entry: entry.path):
+        digest.update(bytes(rule.path, "utf-8"))
+
+        try:
+            with open(rule.path, "rb") as fin:
+                digest.update(fin.read())
+        except OSError as err:
+            raise FileAccessException(err)
+
+    return digest.hexdigest()
+
+
+class ScanCache:
+    """A persistent map of content digest to previously generated findings.
+
+    The cache is a pair of files per rule pack fingerprint: a fixed-width record index
+    which is memory-mapped at start-up - no parsing - and a data file holding the
+    serialized findings, which is only read on a hit. New results are buffered and
+    appended to both files by save().
+
+    The cache is strictly single-writer: an exclusive lock is held per fingerprint
+    for the lifetime of the instance, so a second run pointed at the same cache
+    fails fast rather than interleaving appends and corrupting the data file.
+    """
+
+    def __init__(self, directory: str, pack_fingerprint: str):
+        self.index_path = os.path.join(directory, f"{pack_fingerprint}.idx")
+        self.data_path = os.path.join(directory, f"{pack_fingerprint}.dat")
+        self.entries = {}
+        self.additions = {}
+
+        os.makedirs(directory, exist_ok=True)
+
+        self.lock = open(os.path.join(directory, f"{pack_fingerprint}.lock"), "w")
+
+        try:
+            fcntl.flock(self.lock, fcntl.LOCK_EX | fcntl.LOCK_NB)
+        except OSError:
+            self.lock.close()
+            self.lock = None
+            raise FileAccessException(
+                f"Scan cache at {directory} is already in use by another process"
+            )
+
+        try:
+            with open(self.index_path, "rb") as fin:
+                with mmap.mmap(fin.fileno(), 0, access=mmap.ACCESS_READ) as index:
+                    # A torn final record - from a crash mid-append - is ignored,
+                    # and will be overwritten by the next save.
+                    usable = len(index) - (len(index) % INDEX_RECORD.size)
+
+                    for digest, offset, length in INDEX_RECORD.iter_unpack(
+                        index[:usable]
+                    ):
+                        self.entries[digest.hex()] = (offset, length)
+        except FileNotFoundError:
+            # A missing index is just a cold cache.
+            pass
+        except ValueError:
+            # An empty index cannot be mapped, which is also a cold cache.
+            pass
+
+    def close(self) -> None:
+        """Releases the cache lock, allowing another process to take it over."""
+        if self.lock is not None:
+            self.lock.close()
+            self.lock = None
+
+    def get(self, digest: str) -> Optional[List[finding.Entry]]:
+        """Returns the cached findings for a digest, or None on a miss."""
+        addition = self.additions.get(digest)
+
+        if addition is not None:
+            return [finding.Entry(**entry) for entry in json.loads(addition)]
+
+        location = self.entries.get(digest)
+
+        if location is None:
+            return None
+
+        offset, length = location
+
+        try:
+            with open(self.data_path, "rb") as fin:
+                fin.seek(offset)
+                raw = fin.read(length)
+
+            return [finding.Entry(**entry) for entry in json.loads(raw)]
+        except (OSError, ValueError):
+            # A missing or damaged data file is treated as a miss. The digest is
+            # evicted so that put() can record fresh results - the index is append
+            # only, and the newest record for a digest wins on load.
+            del self.entries[digest]
+            return None
+
+    def put(self, digest: str, findings: List[finding.Entry]) -> None:
+        """Records the findings for a digest, including an empty set of findings."""
+        if digest in self.entries or digest in self.additions:
+            return
+
+        self.additions[digest] = (
+            "[" + ",".join(entry.json() for entry in findings) + "]"
+        )
+
+    def save(self) -> None:
+        """Appends all buffered results to the on-disk cache."""
+        if not self.additions:
+            return
+
+        with open(self.data_path, "ab") as data, open(self.index_path, "ab") as index:
+            for digest, raw in self.additions.items():
+                payload = bytes(raw, "utf-8")
+
+                offset = data.tell()
+                data.write(payload)
+                index.write(
+                    INDEX_RECORD.pack(bytes.fromhex(digest), offset, len(payload))
+                )
+
+        self.additions = {}
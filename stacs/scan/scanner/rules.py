@@ -5,29 +5,39 @@ SPDX-License-Identifier: BSD-3-Clause
 
 import base64
 import hashlib
-import os
-from concurrent.futures import ThreadPoolExecutor, as_completed
-from typing import List
+import json
+import time
+from concurrent.futures import ProcessPoolExecutor, ThreadPoolExecutor, as_completed
+from multiprocessing import shared_memory
+from typing import Dict, List
 
 import yara
+from stacs.native import meta, scanner
+from stacs.scan import telemetry
 from stacs.scan.constants import CHUNK_SIZE, WINDOW_SIZE
 from stacs.scan.exceptions import FileAccessException, InvalidFormatException
 from stacs.scan.loader import archive
 from stacs.scan.model import finding, manifest, pack
 
+# MIME type prefixes which are treated as binary. This is a bit false positive prone,
+# as some "application" mime types are text. However, as we only support a finite
+# number of formats, we should be safe to do this (for now!)
+BINARY_MIME_TYPES = (
+    "application",
+    "image",
+    "audio",
+    "video",
+)
+
 
 def is_binary(target: manifest.Entry) -> bool:
     """Attempts to determine if a target file is binary."""
-    # This is a bit false positive prone, as some "application" mime types are text.
-    # However, as we only support a finite number of formats, we should be safe to do
-    # this (for now!)
-    binary_types = (
-        "application",
-        "image",
-        "audio",
-        "video",
-    )
-    if target.mime and target.mime.startswith(binary_types):
+    # The metadata pass classifies file contents natively, so a precomputed answer is
+    # usually already on the manifest entry.
+    if target.binary is not None:
+        return target.binary
+
+    if target.mime and target.mime.startswith(BINARY_MIME_TYPES):
         return True
 
     # Otherwise, we'll try and read some data as text and see. This could fail if a
@@ -43,74 +53,65 @@ def is_binary(target: manifest.Entry) -> bool:
     return False
 
 
-def generate_sample(target: manifest.Entry, offset: int, size: int) -> finding.Sample:
-    """Generates a sample for a finding."""
-    binary = is_binary(target)
+def generate_samples(
+    target: manifest.Entry, spans: List[tuple]
+) -> List[finding.Sample]:
+    """Generates samples for all findings in a target in a single native pass.
 
-    before = bytes()
-    after = bytes()
-    entry = bytes()
+    The target is mapped once and only the context windows themselves are copied out,
+    rather than the file being opened and seeked three times per finding. Each window
+    is classified as text or binary natively, as part of the same pass.
+    """
+    binary = is_binary(target)
+    samples = []
 
     try:
-        # Make sure we don't try and read past the beginning and end of the file.
-        target_sz = os.stat(target.path).st_size
-
-        if offset - WINDOW_SIZE < 0:
-            before_sz = offset
-            before_offset = 0
-        else:
-            before_sz = WINDOW_SIZE
-            before_offset = offset - before_sz
-
-        # Ensure we read N bytes AFTER the entire match, not after the first byte of the
-        # match.
-        if offset + size + WINDOW_SIZE > target_sz:
-            after_sz = target_sz - (offset + size)
-            after_offset = target_sz - after_sz
-        else:
-            after_sz = WINDOW_SIZE
-            after_offset = offset + size
-
-        with open(target.path, "rb") as fin:
-            # Seek to and read in the context before.
-            fin.seek(before_offset)
-            before = fin.read(before_sz)
-
-            # Read the finding match itself. We have this already from yara, but we're
-            # already here so we may as well.
-            fin.seek(offset)
-            entry = fin.read(size)
-
-            # Seek to and read in the context after the finding.
-            fin.seek(after_offset)
-            after = fin.read(after_sz)
-    except OSError as err:
+        windows = scanner.sample_windows(target.path, spans, WINDOW_SIZE)
+    except scanner.ScannerError as err:
         raise FileAccessException(err)
 
-    if not binary:
-        try:
-            return finding.Sample(
+    for window in windows:
+        if not binary and window.text:
+            samples.append(
+                finding.Sample(
+                    window=WINDOW_SIZE,
+                    before=str(window.before, "utf-8"),
+                    after=str(window.after, "utf-8"),
+                    finding=str(window.match, "utf-8"),
+                    binary=False,
+                )
+            )
+            continue
+
+        samples.append(
+            finding.Sample(
                 window=WINDOW_SIZE,
-                before=str(before, "utf-8"),
-                after=str(after, "utf-8"),
-                finding=str(entry, "utf-8"),
+                before=base64.b64encode(window.before),
+                after=base64.b64encode(window.after),
+                finding=base64.b64encode(window.match),
                 binary=binary,
             )
-        except UnicodeDecodeError:
-            # Fall through and return a base64 encoded sample.
-            pass
-
-    return finding.Sample(
-        window=WINDOW_SIZE,
-        before=base64.b64encode(before),
-        after=base64.b64encode(after),
-        finding=base64.b64encode(entry),
-        binary=binary,
-    )
+        )
+
+    return samples
+
 
+def generate_sample(target: manifest.Entry, offset: int, size: int) -> finding.Sample:
+    """Generates a sample for a finding."""
+    return generate_samples(target, [(offset, size)])[0]
 
-def generate_location(target: manifest.Entry, offset: int) -> finding.Location:
+
+def generate_location(
+    target: manifest.Entry,
+    offset: int,
+    index: "scanner.LineIndex" = None,
+) -> finding.Location:
     """Generates a location for a finding."""
+    # Where a line index has been built for the target, the offset resolves with a
+    # binary search rather than a re-read of the file.
+    if index is not None:
+        return finding.Location(offset=offset, line=index.line_number(offset))
+
     # If the file is binary, we can't generate a line number so we already have the data
     # we need.
     if is_binary(target):
@@ -136,16 +137,25 @@ def generate_location(target: manifest.Entry, offset: int) -> finding.Location:
     return finding.Location(offset=offset, line=line_number)
 
 
-def generate_findings(target: manifest.Entry, match: yara.Match) -> List[finding.Entry]:
+def generate_findings(
+    target: manifest.Entry,
+    match: yara.Match,
+    index: "scanner.LineIndex" = None,
+) -> List[finding.Entry]:
     """Attempts to create findings based on matches inside of the target file."""
     findings = []
 
+    # All sample windows for the match are extracted in a single native pass over
+    # the target, rather than three reads per finding.
+    samples = generate_samples(
+        target, [(offset, len(entry)) for offset, _, entry in match.strings]
+    )
+
     # Generate a new finding entry for each matched string. This is in order to ensure
     # that multiple findings in the same file are listed separately - as they may be
     # different credentials.
-    for offset, _, entry in match.strings:
-        location = generate_location(target, offset)
-        sample = generate_sample(target, offset, len(entry))
+    for (offset, _, entry), sample in zip(match.strings, samples):
+        location = generate_location(target, offset, index=index)
 
         # Add on information about the origin of the finding (that's us!)
         source = finding.Source(
@@ -170,18 +180,145 @@ def generate_findings(target: manifest.Entry, match: yara.Match) -> List[finding
 
 def matcher(target: manifest.Entry, ruleset: yara.Rules) -> List[finding.Entry]:
     findings = []
+    index = None
+    matches = ruleset.match(target.path)
+
+    # Build the newline index once per matched target, so that every finding offset
+    # resolves to a line number by binary search - rather than re-reading the file
+    # from the start for each finding.
+    if matches and not is_binary(target):
+        try:
+            index = scanner.LineIndex(target.path)
+        except scanner.ScannerError as err:
+            raise FileAccessException(err)
 
-    for match in ruleset.match(target.path):
-        findings.extend(generate_findings(target, match))
+    for match in matches:
+        findings.extend(generate_findings(target, match, index=index))
 
     return findings
 
 
+# Populated in scan worker processes by process_worker_init, so that the manifest is
+# deserialized and the ruleset compiled exactly once per worker - not per task.
+_worker_targets = None
+_worker_ruleset = None
+
+
+def process_worker_init(name: str, size: int, namespaces: Dict[str, str]) -> None:
+    """Initialises a scan worker process from the shared manifest region."""
+    global _worker_targets, _worker_ruleset
+
+    region = shared_memory.SharedMemory(name=name)
+    _worker_targets = [
+        manifest.Entry(**entry) for entry in json.loads(bytes(region.buf[:size]))
+    ]
+    region.close()
+
+    _worker_ruleset = yara.compile(filepaths=namespaces)
+
+
+def process_scan(start: int, end: int, skip_on_eacces: bool) -> Dict[int, List[dict]]:
+    """Scans a slice of the shared manifest, returning findings keyed by index."""
+    results = {}
+
+    for position in range(start, end):
+        try:
+            results[position] = [
+                entry.dict()
+                for entry in matcher(_worker_targets[position], _worker_ruleset)
+            ]
+        except FileAccessException:
+            if not skip_on_eacces:
+                raise
+
+    return results
+
+
+def run_threads(
+    pending: List[manifest.Entry],
+    ruleset: yara.Rules,
+    workers: int,
+    skip_on_eacces: bool,
+    cache: "stacs.scan.scanner.cache.ScanCache",  # noqa: F821
+    findings: List[finding.Entry],
+) -> None:
+    """Runs the matcher over the pending targets on a thread pool."""
+    with ThreadPoolExecutor(max_workers=workers) as pool:
+        futures = {pool.submit(matcher, target, ruleset): target for target in pending}
+
+        for future in as_completed(futures):
+            try:
+                results = future.result()
+            except FileAccessException:
+                if not skip_on_eacces:
+                    raise
+
+                continue
+
+            findings.extend(results)
+
+            if cache is not None and futures[future].md5:
+                cache.put(futures[future].md5, results)
+
+
+def run_processes(
+    pending: List[manifest.Entry],
+    namespaces: Dict[str, str],
+    processes: int,
+    skip_on_eacces: bool,
+    cache: "stacs.scan.scanner.cache.ScanCache",  # noqa: F821
+    findings: List[finding.Entry],
+) -> None:
+    """Runs the matcher over the pending targets on a process pool.
+
+    The manifest is serialized once into a shared memory region which each worker maps
+    and deserializes at start-up, so tasks are plain index ranges rather than entries
+    pickled per task.
+    """
+    payload = bytes(json.dumps([target.dict() for target in pending]), "utf-8")
+
+    region = shared_memory.SharedMemory(create=True, size=len(payload))
+    region.buf[: len(payload)] = payload
+
+    # Slice the manifest into a few ranges per worker, so one slow slice cannot stall
+    # the whole run.
+    step = max(len(pending) // (processes * 4), 1)
+
+    try:
+        with ProcessPoolExecutor(
+            max_workers=processes,
+            initializer=process_worker_init,
+            initargs=(region.name, len(payload), namespaces),
+        ) as pool:
+            futures = [
+                pool.submit(
+                    process_scan,
+                    start,
+                    min(start + step, len(pending)),
+                    skip_on_eacces,
+                )
+                for start in range(0, len(pending), step)
+            ]
+
+            for future in as_completed(futures):
+                for position, results in future.result().items():
+                    entries = [finding.Entry(**result) for result in results]
+                    findings.extend(entries)
+
+                    if cache is not None and pending[position].md5:
+                        cache.put(pending[position].md5, entries)
+    finally:
+        region.close()
+        region.unlink()
+
+
 def run(
     targets: List[manifest.Entry],
     pack: pack.Format,
     workers: int = 10,
     skip_on_eacces: bool = True,
+    cache: "stacs.scan.scanner.cache.ScanCache" = None,  # noqa: F821
+    processes: int = 0,
 ) -> List[finding.Entry]:
     """
     Executes the rules based matcher on all input files, returning a list of finding
@@ -201,26 +338,92 @@ def run(
     except yara.Error as err:
         raise InvalidFormatException(err)
 
-    # Run the matcher in a thread pool as we're likely to be I/O bound.
-    with ThreadPoolExecutor(max_workers=workers) as pool:
-        futures = []
-
-        # Reject any input files which are supported archives. This is as we should have
-        # unpacked versions of these to process, which allows matching the specific file
-        # with a finding, rather than a finding on an archive.
-        #
-        # NOTE: Credentials stuffed into metadata of supported archive formats which
-        #       support archive metadata (such as Zip's "Extra") will not be found.
-        #
-        for target in targets:
-            if target.mime not in archive.MIME_TYPE_HANDLERS:
-                futures.append(pool.submit(matcher, target, ruleset))
+    # Where the pack supplies literal atoms, files containing none of them cannot
+    # match any rule - so they are filtered out natively before yara is invoked.
+    prefilter = scanner.Prefilter(pack.atoms) if pack.atoms else None
+
+    # Identical content need only be scanned once: the first occurrence of each digest
+    # is submitted to the matcher, and later occurrences are linked to its findings
+    # below. Nested archives make this common - the same file routinely appears in
+    # dozens of container layers.
+    index = meta.DigestIndex()
+    duplicates = {}
+
+    # Reject any input files which are supported archives. This is as we should have
+    # unpacked versions of these to process, which allows matching the specific file
+    # with a finding, rather than a finding on an archive.
+    #
+    # NOTE: Credentials stuffed into metadata of supported archive formats which
+    #       support archive metadata (such as Zip's "Extra") will not be found.
+    #
+    pending = []
+
+    for target in targets:
+        if target.mime in archive.MIME_TYPE_HANDLERS:
+            continue
+
+        if target.md5 and not index.insert(target.md5):
+            duplicates.setdefault(target.md5, []).append(target)
+            continue
+
+        # Content scanned by a previous run with the same rule pack resolves from
+        # the persistent cache, including content which had no findings.
+        if cache is not None and target.md5:
+            cached = cache.get(target.md5)
+
+            if cached is not None:
+                for entry in cached:
+                    entry.path = target.overlay if target.overlay else target.path
+
+                findings.extend(cached)
+                continue
+
+        pending.append(target)
+
+    # Run the prefilter over all remaining targets in one native batch, submitting
+    # only files which contain at least one atom. Filtered files have no findings,
+    # which is also worth caching.
+    if prefilter is not None and pending:
+        hits = prefilter.filter([target.path for target in pending])
+        remaining = []
+
+        for target, hit in zip(pending, hits):
+            if hit:
+                remaining.append(target)
+                continue
+
+            if cache is not None and target.md5:
+                cache.put(target.md5, [])
+
+        pending = remaining
+
+    started = time.monotonic()
+
+    if processes > 1 and pending:
+        run_processes(pending, namespaces, processes, skip_on_eacces, cache, findings)
+    elif pending:
+        run_threads(pending, ruleset, workers, skip_on_eacces, cache, findings)
+
+    telemetry.record(
+        "scanner:rules",
+        time.monotonic() - started,
+        calls=len(pending),
+        findings=len(findings),
+    )
 
-        for future in as_completed(futures):
-            try:
-                findings.extend(future.result())
-            except FileAccessException:
-                if not skip_on_eacces:
-                    raise
+    if cache is not None:
+        cache.save()
+
+    # Replicate findings from each scanned file onto its duplicates, under the
+    # duplicate's own path.
+    replicated = []
+
+    for entry in findings:
+        for duplicate in duplicates.get(entry.md5, []):
+            clone = entry.copy(deep=True)
+            clone.path = duplicate.overlay if duplicate.overlay else duplicate.path
+            replicated.append(clone)
+
+    findings.extend(replicated)
 
     return findings
@@ -0,0 +1,47 @@
+"""Aggregates lightweight runtime telemetry for STACS.
+
+Counters are recorded against a free-form name - such as the MIME type of an archive
+handler - and summed across the run. Collection is always on: a record is a lock
+acquisition and a handful of additions, which is negligible next to the operations
+being measured.
+
+SPDX-License-Identifier: BSD-3-Clause
+"""
+
+import threading
+from typing import Dict
+
+_lock = threading.Lock()
+_counters: Dict[str, Dict[str, float]] = {}
+
+
+def record(name: str, seconds: float = 0.0, calls: int = 1, **extra: int) -> None:
+    """Records a timed operation against the provided name.
+
+    Additional keyword arguments are summed as named counters - such as the byte
+    counts reported by the native archive reader.
+    """
+    with _lock:
+        entry = _counters.setdefault(name, {"calls": 0, "seconds": 0.0})
+        entry["calls"] += calls
+        entry["seconds"] += seconds
+
+        for key, value in extra.items():
+            entry[key] = entry.get(key, 0) + value
+
+
+def snapshot() -> Dict[str, Dict[str, float]]:
+    """Returns a copy of all aggregated counters, ordered by total time spent."""
+    with _lock:
+        return {
+            name: dict(entry)
+            for name, entry in sorted(
+                _counters.items(), key=lambda item: item[1]["seconds"], reverse=True
+            )
+        }
+
+
+def reset() -> None:
+    """Clears all aggregated counters."""
+    with _lock:
+        _counters.clear()
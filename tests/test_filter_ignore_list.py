@@ -169,3 +169,50 @@ class STACSFilterIgnoreListTestCase(unittest.TestCase):
             md5="fa19207ef28b6a97828e3a22b11290e9", reason="Test", offset=1234
         )
         self.assertEqual(stacs.scan.filter.ignore_list.by_hash(finding, miss), False)
+
+    def test_process_python_pattern(self):
+        """Validate that Python specific regex constructs are still honoured."""
+        findings = [
+            stacs.scan.model.finding.Entry(
+                path="/a/TESTS/a",
+                md5="fa19207ef28b6a97828e3a22b11290e9",
+                location=stacs.scan.model.finding.Location(
+                    offset=300,
+                ),
+                source=stacs.scan.model.finding.Source(
+                    module="stacs.scan.scanner.rules",
+                    reference="SomeRule",
+                ),
+            ),
+        ]
+
+        # Inline flags are valid for re but not for the native engine, so this
+        # entry must be evaluated by the Python fallback.
+        ignores = stacs.scan.model.ignore_list.Format(
+            ignore=[
+                stacs.scan.model.ignore_list.Entry(
+                    pattern="(?i).*/tests/.*", reason="Case insensitive ignore"
+                ),
+            ]
+        )
+
+        results = stacs.scan.filter.ignore_list.process(findings, ignores)
+
+        self.assertEqual(results[0].ignore.ignored, True)
+        self.assertEqual(results[0].ignore.reason, "Case insensitive ignore")
+
+    def test_compile_invalid_pattern(self):
+        """Validate that invalid patterns are reported with pattern and reason."""
+        ignores = stacs.scan.model.ignore_list.Format(
+            ignore=[
+                stacs.scan.model.ignore_list.Entry(
+                    pattern="(unterminated", reason="Broken entry"
+                ),
+            ]
+        )
+
+        with self.assertRaises(stacs.scan.exceptions.IgnoreListException) as scope:
+            stacs.scan.filter.ignore_list.compile(ignores)
+
+        self.assertIn("Broken entry", str(scope.exception))
+        self.assertIn("(unterminated", str(scope.exception))
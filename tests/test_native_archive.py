@@ -0,0 +1,103 @@
+"""Tests the STACS native archive extraction pool."""
+
+import os
+import shutil
+import tarfile
+import tempfile
+import unittest
+
+from stacs.native import archive
+
+
+class STACSNativeArchiveTestCase(unittest.TestCase):
+    """Tests the STACS native archive extraction pool."""
+
+    def setUp(self):
+        """Ensure the application is setup for testing."""
+        self.workdir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        """Ensure everything is torn down between tests."""
+        shutil.rmtree(self.workdir)
+
+    def create_tarball(self, name: str, members: dict) -> str:
+        """Creates a tarball containing the provided members, returning its path."""
+        path = os.path.join(self.workdir, name)
+
+        with tarfile.open(path, "w:gz") as tarball:
+            for member, contents in members.items():
+                source = os.path.join(self.workdir, os.path.basename(member))
+
+                with open(source, "wb") as fout:
+                    fout.write(contents)
+
+                tarball.add(source, arcname=member)
+
+        return path
+
+    def test_pool_extracts_submitted_archives(self):
+        """Ensure every submitted archive is extracted and reported exactly once."""
+        first = self.create_tarball(
+            "first.tar.gz", {"directory/one": b"one", "two": b"two"}
+        )
+        second = self.create_tarball("second.tar.gz", {"three": b"three"})
+
+        destinations = {
+            first: os.path.join(self.workdir, "first-out"),
+            second: os.path.join(self.workdir, "second-out"),
+        }
+
+        pool = archive.ArchiveExtractorPool(workers=2)
+
+        for filename, destination in destinations.items():
+            pool.submit(filename, destination)
+
+        pool.close()
+        results = list(pool)
+
+        self.assertEqual(len(results), 2)
+
+        for result in results:
+            self.assertTrue(result.success)
+            self.assertEqual(result.directory, destinations[result.filename])
+
+        with open(os.path.join(destinations[first], "directory/one"), "rb") as fin:
+            self.assertEqual(fin.read(), b"one")
+
+        with open(os.path.join(destinations[second], "three"), "rb") as fin:
+            self.assertEqual(fin.read(), b"three")
+
+    def test_pool_surfaces_corrupt_archives(self):
+        """Ensure corrupt archives are reported per-result, not raised pool-wide."""
+        valid = self.create_tarball("valid.tar.gz", {"member": b"contents"})
+        corrupt = os.path.join(self.workdir, "corrupt.tar.gz")
+
+        # A plausible gzip magic followed by garbage, so the failure occurs
+        # during extraction rather than at submission.
+        with open(corrupt, "wb") as fout:
+            fout.write(b"\x1f\x8b" + b"\xff" * 64)
+
+        pool = archive.ArchiveExtractorPool(workers=2)
+        pool.submit(valid, os.path.join(self.workdir, "valid-out"))
+        pool.submit(corrupt, os.path.join(self.workdir, "corrupt-out"))
+        pool.close()
+
+        results = {result.filename: result for result in pool}
+
+        self.assertEqual(len(results), 2)
+        self.assertTrue(results[valid].success)
+        self.assertFalse(results[corrupt].success)
+        self.assertTrue(results[corrupt].error)
+
+    def test_pool_rejects_submissions_after_close(self):
+        """Ensure a closed pool refuses new work and terminates iteration."""
+        pool = archive.ArchiveExtractorPool(workers=1)
+        pool.close()
+
+        with self.assertRaises(RuntimeError):
+            pool.submit(
+                os.path.join(self.workdir, "late.tar.gz"),
+                os.path.join(self.workdir, "late-out"),
+            )
+
+        self.assertEqual(list(pool), [])
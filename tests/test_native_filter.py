@@ -0,0 +1,171 @@
+"""Tests the STACS native ignore list matching engine."""
+
+import unittest
+
+from stacs.native import filter
+
+# The module which generates rule findings, used as the default gate in real
+# ignore lists.
+RULES_MODULE = "stacs.scan.scanner.rules"
+
+
+class STACSNativeFilterTestCase(unittest.TestCase):
+    """Tests the STACS native ignore list matching engine."""
+
+    def setUp(self):
+        """Ensure the application is setup for testing."""
+        pass
+
+    def tearDown(self):
+        """Ensure everything is torn down between tests."""
+        pass
+
+    def rule(
+        self,
+        path="",
+        pattern="",
+        md5="",
+        module=RULES_MODULE,
+        references=None,
+        offset=-1,
+    ):
+        """Builds an ignore rule tuple, with unset criteria defaulted."""
+        return (path, pattern, md5, module, references if references else [], offset)
+
+    def candidate(self, path, md5="", reference="CredentialPattern", offset=-1):
+        """Builds a finding candidate tuple from the rules module."""
+        return (path, md5, RULES_MODULE, reference, offset)
+
+    def test_path_rule(self):
+        """Ensure exact path rules only suppress findings with that path."""
+        matcher = filter.IgnoreMatcher([self.rule(path="/tmp/rootfs/etc/config")])
+
+        self.assertEqual(
+            matcher.match(
+                [
+                    self.candidate("/tmp/rootfs/etc/config"),
+                    self.candidate("/tmp/rootfs/etc/passwd"),
+                ]
+            ),
+            [0, -1],
+        )
+
+    def test_pattern_rule(self):
+        """Ensure pattern rules suppress findings matching anywhere in the path."""
+        matcher = filter.IgnoreMatcher([self.rule(pattern=r"\.tar!")])
+
+        self.assertEqual(
+            matcher.match(
+                [
+                    self.candidate("/tmp/rootfs/a.tar.gz!a.tar!cred"),
+                    self.candidate("/tmp/rootfs/etc/config"),
+                ]
+            ),
+            [0, -1],
+        )
+
+    def test_hash_rule(self):
+        """Ensure hash rules suppress findings by content digest."""
+        matcher = filter.IgnoreMatcher(
+            [self.rule(md5="bf072e9119077b4e76437a93986787ef")]
+        )
+
+        self.assertEqual(
+            matcher.match(
+                [
+                    self.candidate(
+                        "/tmp/rootfs/etc/config",
+                        md5="bf072e9119077b4e76437a93986787ef",
+                    ),
+                    self.candidate(
+                        "/tmp/rootfs/etc/config",
+                        md5="b39bfc0e26a30024c76e4dcb8a1eae87",
+                    ),
+                ]
+            ),
+            [0, -1],
+        )
+
+    def test_module_gate(self):
+        """Ensure rules only suppress findings from their own module."""
+        matcher = filter.IgnoreMatcher(
+            [self.rule(path="/tmp/rootfs/etc/config", module="another.module")]
+        )
+
+        self.assertEqual(
+            matcher.match([self.candidate("/tmp/rootfs/etc/config")]),
+            [-1],
+        )
+
+    def test_reference_gate(self):
+        """Ensure rules with references only suppress the listed references."""
+        matcher = filter.IgnoreMatcher(
+            [
+                self.rule(
+                    path="/tmp/rootfs/etc/config",
+                    references=["CredentialPattern", "PrivateKeyMaterial"],
+                )
+            ]
+        )
+
+        self.assertEqual(
+            matcher.match(
+                [
+                    self.candidate(
+                        "/tmp/rootfs/etc/config", reference="CredentialPattern"
+                    ),
+                    self.candidate(
+                        "/tmp/rootfs/etc/config", reference="SomethingElse"
+                    ),
+                ]
+            ),
+            [0, -1],
+        )
+
+    def test_offset_gate(self):
+        """Ensure rules with an offset only suppress findings at that offset."""
+        matcher = filter.IgnoreMatcher(
+            [self.rule(path="/tmp/rootfs/etc/config", offset=42)]
+        )
+
+        self.assertEqual(
+            matcher.match(
+                [
+                    self.candidate("/tmp/rootfs/etc/config", offset=42),
+                    self.candidate("/tmp/rootfs/etc/config", offset=41),
+                    self.candidate("/tmp/rootfs/etc/config"),
+                ]
+            ),
+            [0, -1, -1],
+        )
+
+    def test_first_match_wins(self):
+        """Ensure the earliest matching rule suppresses, regardless of its type."""
+        pattern = self.rule(pattern=r"^/tmp/rootfs/")
+        path = self.rule(path="/tmp/rootfs/etc/config")
+        findings = [self.candidate("/tmp/rootfs/etc/config")]
+
+        # The index of the first rule is always returned, whether the pattern or
+        # the path rule appears first in the list.
+        self.assertEqual(
+            filter.IgnoreMatcher([pattern, path]).match(findings), [0]
+        )
+        self.assertEqual(
+            filter.IgnoreMatcher([path, pattern]).match(findings), [0]
+        )
+
+    def test_unsupported_patterns(self):
+        """Ensure patterns the engine cannot compile are reported, not fatal."""
+        matcher = filter.IgnoreMatcher(
+            [
+                self.rule(pattern=r"(?P<name>cred)"),
+                self.rule(path="/tmp/rootfs/etc/config"),
+            ]
+        )
+
+        # The Python specific pattern is reported by rule index for the caller
+        # to evaluate another way, while the remaining rules match natively.
+        self.assertEqual(list(matcher.unsupported()), [0])
+        self.assertEqual(
+            matcher.match([self.candidate("/tmp/rootfs/etc/config")]), [1]
+        )
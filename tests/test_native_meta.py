@@ -0,0 +1,74 @@
+"""Tests the STACS native metadata engine."""
+
+import hashlib
+import os
+import shutil
+import tempfile
+import unittest
+
+from stacs.native import meta
+
+
+class STACSNativeMetaTestCase(unittest.TestCase):
+    """Tests the STACS native metadata engine."""
+
+    def setUp(self):
+        """Ensure the application is setup for testing."""
+        self.workdir = tempfile.mkdtemp()
+        self.matcher = meta.MagicMatcher([])
+
+    def tearDown(self):
+        """Ensure everything is torn down between tests."""
+        shutil.rmtree(self.workdir)
+
+    def summarize(self, contents: bytes) -> "meta.FileSummary":
+        """Writes the provided contents to disk and summarizes the result."""
+        path = os.path.join(self.workdir, "sample")
+
+        with open(path, "wb") as fout:
+            fout.write(contents)
+
+        return meta.summarize([path], self.matcher)[0]
+
+    def test_md5_rfc1321_vectors(self):
+        """Ensure the native MD5 matches the RFC 1321 test vectors."""
+        vectors = [
+            (b"", "d41d8cd98f00b204e9800998ecf8427e"),
+            (b"a", "0cc175b9c0f1b6a831c399e269772661"),
+            (b"abc", "900150983cd24fb0d6963f7d28e17f72"),
+            (b"message digest", "f96b697d7cb7938d525a2f31aaf161d0"),
+            (b"abcdefghijklmnopqrstuvwxyz", "c3fcd3d76192e4007dfb496cca67e13b"),
+            (
+                b"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+                "d174ab98d277d9f5a5611c2c9f419d9f",
+            ),
+            (
+                b"1234567890" * 8,
+                "57edf4a22be3c955ac49da2e2107b67a",
+            ),
+        ]
+
+        for contents, digest in vectors:
+            summary = self.summarize(contents)
+            self.assertEqual(summary.error, "")
+            self.assertEqual(summary.md5, digest)
+
+    def test_md5_block_boundaries(self):
+        """Ensure digests are correct around the 64-byte MD5 block boundary."""
+        for size in [55, 56, 57, 63, 64, 65, 127, 128, 129]:
+            contents = bytes([size % 256]) * size
+            self.assertEqual(
+                self.summarize(contents).md5,
+                hashlib.md5(contents).hexdigest(),
+            )
+
+    def test_md5_multiple_read_chunks(self):
+        """Ensure digests are correct for files spanning multiple read chunks."""
+        # Sized well past the native read chunk, with an odd length so that the
+        # final read is partial.
+        contents = bytes(range(256)) * 12289 + b"tail"
+
+        self.assertEqual(
+            self.summarize(contents).md5,
+            hashlib.md5(contents).hexdigest(),
+        )
@@ -0,0 +1,55 @@
+"""Tests the STACS native JSON encoder."""
+
+import json
+import unittest
+
+from stacs.native import output
+
+
+class STACSNativeOutputTestCase(unittest.TestCase):
+    """Tests the STACS native JSON encoder."""
+
+    def setUp(self):
+        """Ensure the application is setup for testing."""
+        pass
+
+    def tearDown(self):
+        """Ensure everything is torn down between tests."""
+        pass
+
+    def test_round_trip(self):
+        """Ensure encoded documents decode back to the original object."""
+        document = {
+            "none": None,
+            "bools": [True, False],
+            "ints": [0, -1, 2**63, -(2**70)],
+            "floats": [0.5, -12.25, 1e300],
+            "strings": ["", "plain", "unicode £ é ☃"],
+            "nested": {"inner": {"list": [1, [2, [3]]]}},
+            "empty": [{}, []],
+        }
+
+        self.assertEqual(json.loads(output.encode(document)), document)
+
+    def test_escaping(self):
+        """Ensure string escaping matches the Python encoder byte-for-byte."""
+        sample = 'quote " backslash \\ newline \n tab \t control \x01 unicode é'
+
+        self.assertEqual(
+            str(output.encode(sample), "utf-8"),
+            json.dumps(sample, ensure_ascii=False),
+        )
+
+    def test_unsupported_type(self):
+        """Ensure objects without a JSON representation are rejected."""
+        with self.assertRaises(TypeError):
+            output.encode({"unsupported": {1, 2}})
+
+    def test_depth_limit(self):
+        """Ensure deeply nested documents are rejected rather than overflowing."""
+        document = []
+        for _ in range(200):
+            document = [document]
+
+        with self.assertRaises(ValueError):
+            output.encode(document)
@@ -1,5 +1,8 @@
 """Tests the STACS SARIF output module."""
 
+import base64
+import io
+import json
 import unittest
 
 import stacs.scan
@@ -58,3 +61,190 @@ class STACSOutputSARIFTestCase(unittest.TestCase):
 
         # Ensure findings are unfurled into the expected number of unique artifacts.
         self.assertEqual(len(artifacts), 12)
+
+    def test_stream_document(self):
+        """Ensure streamed output matches an independently constructed document."""
+        findings = [
+            stacs.scan.model.finding.Entry(
+                path="/tmp/rootfs/etc/config",
+                md5="b39bfc0e26a30024c76e4dcb8a1eae87",
+                confidence=90,
+                location=stacs.scan.model.finding.Location(line=3, offset=42),
+                sample=stacs.scan.model.finding.Sample(
+                    window=20,
+                    before="password = ",
+                    after="\n",
+                    finding="hunter2",
+                    binary=False,
+                ),
+                source=stacs.scan.model.finding.Source(
+                    module="stacs.scan.scanner.rules",
+                    reference="CredentialInConfiguration",
+                    description="A static credential inside of a configuration file",
+                ),
+            ),
+            stacs.scan.model.finding.Entry(
+                path="/tmp/rootfs/a.tar.gz!a.tar!cred",
+                md5="bf072e9119077b4e76437a93986787ef",
+                confidence=50,
+                location=stacs.scan.model.finding.Location(offset=1024),
+                sample=stacs.scan.model.finding.Sample(
+                    window=20,
+                    before=str(base64.b64encode(b"\x00\x01"), "utf-8"),
+                    after=str(base64.b64encode(b"\x02\x03"), "utf-8"),
+                    finding=str(base64.b64encode(b"-----BEGIN"), "utf-8"),
+                    binary=True,
+                ),
+                source=stacs.scan.model.finding.Source(
+                    module="stacs.scan.scanner.rules",
+                    reference="PrivateKeyMaterial",
+                    description="Private key material inside of a binary",
+                ),
+            ),
+        ]
+        pack = stacs.scan.model.pack.Format()
+
+        # The expected document is constructed by hand, rather than derived from
+        # the encoder under test.
+        rules = [
+            {
+                "id": "CredentialInConfiguration",
+                "shortDescription": {
+                    "text": "A static credential inside of a configuration file",
+                },
+            },
+            {
+                "id": "PrivateKeyMaterial",
+                "shortDescription": {
+                    "text": "Private key material inside of a binary",
+                },
+            },
+        ]
+        expected = {
+            "version": "2.1.0",
+            "$schema": (
+                "https://schemastore.azurewebsites.net/schemas/json/sarif-2.1.0.json"
+            ),
+            "runs": [
+                {
+                    "results": [
+                        {
+                            "message": rules[0]["shortDescription"],
+                            "level": "error",
+                            "ruleId": "CredentialInConfiguration",
+                            "locations": [
+                                {
+                                    "physicalLocation": {
+                                        "region": {
+                                            "byteOffset": 42,
+                                            "snippet": {"text": "hunter2"},
+                                            "startLine": 3,
+                                        },
+                                        "contextRegion": {
+                                            "snippet": {
+                                                "text": "password = hunter2\n",
+                                            },
+                                        },
+                                        "artifactLocation": {
+                                            "uri": "etc/config",
+                                            "index": 0,
+                                            "uriBaseId": "STACSROOT",
+                                        },
+                                    },
+                                },
+                            ],
+                            "suppressions": [],
+                        },
+                        {
+                            "message": rules[1]["shortDescription"],
+                            "level": "warning",
+                            "ruleId": "PrivateKeyMaterial",
+                            "locations": [
+                                {
+                                    "physicalLocation": {
+                                        "region": {
+                                            "byteOffset": 1024,
+                                            "snippet": {
+                                                "binary": str(
+                                                    base64.b64encode(b"-----BEGIN"),
+                                                    "utf-8",
+                                                ),
+                                            },
+                                        },
+                                        "contextRegion": {
+                                            "snippet": {
+                                                "binary": str(
+                                                    base64.b64encode(
+                                                        b"\x00\x01-----BEGIN\x02\x03"
+                                                    ),
+                                                    "utf-8",
+                                                ),
+                                            },
+                                        },
+                                        "artifactLocation": {
+                                            "uri": "cred",
+                                            "index": 3,
+                                            "uriBaseId": "STACSROOT",
+                                        },
+                                    },
+                                },
+                            ],
+                            "suppressions": [],
+                        },
+                    ],
+                    "tool": {
+                        "driver": {
+                            "name": "STACS",
+                            "rules": rules,
+                            "version": stacs.scan.__about__.__version__,
+                            "downloadUri": stacs.scan.__about__.__uri__,
+                            "informationUri": stacs.scan.__about__.__uri__,
+                        },
+                    },
+                    "artifacts": [
+                        {
+                            "location": {
+                                "uri": "etc/config",
+                                "uriBaseId": "STACSROOT",
+                            },
+                            "hashes": {"md5": "b39bfc0e26a30024c76e4dcb8a1eae87"},
+                        },
+                        {
+                            "location": {
+                                "uri": "a.tar.gz",
+                                "uriBaseId": "STACSROOT",
+                            },
+                        },
+                        {
+                            "location": {
+                                "uri": "a.tar",
+                                "uriBaseId": "STACSROOT",
+                            },
+                            "parentIndex": 1,
+                        },
+                        {
+                            "location": {
+                                "uri": "cred",
+                                "uriBaseId": "STACSROOT",
+                            },
+                            "parentIndex": 2,
+                            "hashes": {"md5": "bf072e9119077b4e76437a93986787ef"},
+                        },
+                    ],
+                    "originalUriBaseIds": {
+                        "STACSROOT": {"uri": "file:///tmp/rootfs/"},
+                    },
+                },
+            ],
+        }
+
+        # Stream the findings, and ensure the document matches the expectation.
+        buffer = io.BytesIO()
+        stacs.scan.output.sarif.stream("/tmp/rootfs/", iter(findings), pack, buffer)
+
+        self.assertEqual(json.loads(buffer.getvalue()), expected)
+
+        # The rendered form must describe the same document.
+        rendered = stacs.scan.output.sarif.render("/tmp/rootfs/", findings, pack)
+
+        self.assertEqual(json.loads(rendered), expected)
@@ -0,0 +1,116 @@
+"""Tests the STACS persistent scan cache."""
+
+import os
+import shutil
+import tempfile
+import unittest
+
+import stacs.scan
+from stacs.scan.scanner.cache import INDEX_RECORD, ScanCache
+
+
+class STACSScannerCacheTestCase(unittest.TestCase):
+    """Tests the STACS persistent scan cache."""
+
+    def setUp(self):
+        """Ensure the application is setup for testing."""
+        self.directory = tempfile.mkdtemp(prefix="stacs-test-")
+        self.fingerprint = "b39bfc0e26a30024c76e4dcb8a1eae87"
+
+    def tearDown(self):
+        """Ensure everything is torn down between tests."""
+        shutil.rmtree(self.directory, ignore_errors=True)
+
+    def test_round_trip(self):
+        """Ensure cached findings survive a save and reload unchanged."""
+        findings = [
+            stacs.scan.model.finding.Entry(
+                path="/tmp/rootfs/etc/passwd",
+                md5="bf072e9119077b4e76437a93986787ef",
+            ),
+        ]
+
+        cache = ScanCache(self.directory, self.fingerprint)
+        cache.put("bf072e9119077b4e76437a93986787ef", findings)
+        cache.put("30cf3d7d133b08543cb6c8933c29dfd7", [])
+        cache.save()
+        cache.close()
+
+        cache = ScanCache(self.directory, self.fingerprint)
+        cached = cache.get("bf072e9119077b4e76437a93986787ef")
+
+        self.assertEqual(len(cached), 1)
+        self.assertEqual(cached[0].path, findings[0].path)
+        self.assertEqual(cached[0].md5, findings[0].md5)
+
+        # An empty set of findings is a hit, and distinct from a miss.
+        self.assertEqual(cache.get("30cf3d7d133b08543cb6c8933c29dfd7"), [])
+        self.assertIsNone(cache.get("57b8d745384127342f95660d97e1c9c2"))
+
+        cache.close()
+
+    def test_truncated_index(self):
+        """Ensure a torn final index record does not prevent loading the cache."""
+        cache = ScanCache(self.directory, self.fingerprint)
+        cache.put("bf072e9119077b4e76437a93986787ef", [])
+        cache.save()
+        cache.close()
+
+        # Simulate a crash mid-append by writing a partial record to the index.
+        with open(
+            os.path.join(self.directory, f"{self.fingerprint}.idx"), "ab"
+        ) as fout:
+            fout.write(b"\xFF" * (INDEX_RECORD.size - 1))
+
+        cache = ScanCache(self.directory, self.fingerprint)
+
+        self.assertEqual(cache.get("bf072e9119077b4e76437a93986787ef"), [])
+        cache.close()
+
+    def test_corrupt_data(self):
+        """Ensure a damaged data file is treated as a miss rather than an error."""
+        findings = [
+            stacs.scan.model.finding.Entry(
+                path="/tmp/rootfs/etc/passwd",
+                md5="bf072e9119077b4e76437a93986787ef",
+            ),
+        ]
+
+        cache = ScanCache(self.directory, self.fingerprint)
+        cache.put("bf072e9119077b4e76437a93986787ef", findings)
+        cache.save()
+        cache.close()
+
+        with open(
+            os.path.join(self.directory, f"{self.fingerprint}.dat"), "wb"
+        ) as fout:
+            fout.write(b"\xFF\xFF\xFF")
+
+        cache = ScanCache(self.directory, self.fingerprint)
+
+        self.assertIsNone(cache.get("bf072e9119077b4e76437a93986787ef"))
+
+        # The damaged entry must be evicted on the miss, so that fresh results can
+        # be recorded and win over the old record on the next load.
+        cache.put("bf072e9119077b4e76437a93986787ef", findings)
+        cache.save()
+        cache.close()
+
+        cache = ScanCache(self.directory, self.fingerprint)
+        repaired = cache.get("bf072e9119077b4e76437a93986787ef")
+
+        self.assertEqual(len(repaired), 1)
+        self.assertEqual(repaired[0].path, findings[0].path)
+        cache.close()
+
+    def test_exclusive_lock(self):
+        """Ensure a second writer against the same cache fails fast."""
+        cache = ScanCache(self.directory, self.fingerprint)
+
+        with self.assertRaises(stacs.scan.exceptions.FileAccessException):
+            ScanCache(self.directory, self.fingerprint)
+
+        cache.close()
+
+        # Once the lock is released, the cache can be reopened.
+        ScanCache(self.directory, self.fingerprint).close()